@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Epoch based reclamation
+/*
+    Readers pin the current global epoch into their own slot while they use shared data and clear it when
+    done: two stores on a cache line nobody else writes, no lock, no read-modify-write. Writers swap in a new
+    version, retire the old one tagged with the current epoch and bump the epoch. A retired object is freed
+    once every pinned reader has an epoch newer than its tag, i.e. nobody can still hold a pointer to it.
+
+    Every thread gets one slot index for its lifetime (shared by all domains, returned on thread exit). Past
+    MAX_THREADS live threads, the extra ones share one overflow slot under a mutex: it holds the epoch of the
+    first of them to pin until the last one unpins, which only delays reclamation, never makes it unsafe.
+
+    shared() is one process wide domain for structures that do not need their own, so each of them does not
+    carry MAX_THREADS reader slots; it is never destroyed, so it can be used from static destructors.
+*/
+class EpochDomain
+{
+public:
+    static constexpr size_t MAX_THREADS = 256;
+
+private:
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<uint64_t> epoch{0};     // 0 -> not pinned
+        size_t depth{0};                    // only touched by the owning thread
+    };
+
+    struct Retired
+    {
+        uint64_t epoch;
+        std::function<void()> free;
+    };
+
+    static constexpr size_t OVERFLOW = MAX_THREADS;     // thread index of threads without a slot of their own
+
+    std::atomic<uint64_t> global_{1};
+    std::array<ReaderSlot, MAX_THREADS + 1> readers_;   // readers_[OVERFLOW]: depth counts all overflow pins
+    std::mutex overflow_mtx_;
+
+    std::mutex retire_mtx_;
+    std::vector<Retired> retired_;
+
+    // process wide thread index allocator
+    struct ThreadIndex
+    {
+        size_t index;
+
+        static std::mutex& mtx() { static std::mutex m; return m; }
+        static std::vector<size_t>& free_list() { static std::vector<size_t> f; return f; }
+        static size_t& next() { static size_t n = 0; return n; }
+
+        ThreadIndex()
+        {
+            std::scoped_lock<std::mutex> lock{mtx()};
+            if(!free_list().empty()) {
+                index = free_list().back();
+                free_list().pop_back();
+            }
+            else if(next() < MAX_THREADS) index = next()++;
+            else index = OVERFLOW;
+        }
+
+        ~ThreadIndex()
+        {
+            std::scoped_lock<std::mutex> lock{mtx()};
+            if(index != OVERFLOW) free_list().push_back(index);
+        }
+    };
+
+    static size_t thread_index()
+    {
+        thread_local ThreadIndex mine;
+        return mine.index;
+    }
+
+    // called with retire_mtx_ held
+    void reclaim()
+    {
+        uint64_t oldest = UINT64_MAX;
+        for(auto &r : readers_) {
+            uint64_t e = r.epoch.load();
+            if(e != 0 && e < oldest) oldest = e;
+        }
+
+        auto keep = std::partition(retired_.begin(), retired_.end(), [&](const Retired &r) { return r.epoch >= oldest; });
+        for(auto it = keep; it != retired_.end(); ++it) it->free();
+        retired_.erase(keep, retired_.end());
+    }
+
+public:
+    // RAII pin, nests
+    class Guard
+    {
+        EpochDomain *domain_;
+        ReaderSlot *slot_;
+    public:
+        Guard(EpochDomain &domain, ReaderSlot &slot) : domain_(&domain), slot_(&slot) {}
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard()
+        {
+            if(slot_ != &domain_->readers_[OVERFLOW]) {
+                if(--slot_->depth == 0) slot_->epoch.store(0, std::memory_order_release);
+                return;
+            }
+            std::scoped_lock<std::mutex> lock{domain_->overflow_mtx_};
+            if(--slot_->depth == 0) slot_->epoch.store(0, std::memory_order_release);
+        }
+    };
+
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    ~EpochDomain()
+    {
+        for(auto &r : retired_) r.free();
+    }
+
+    static EpochDomain& shared()
+    {
+        static EpochDomain *domain = new EpochDomain;
+        return *domain;
+    }
+
+    // pointers loaded from shared atomics after pin() stay valid until the guard is destroyed
+    [[nodiscard]] Guard pin()
+    {
+        size_t index = thread_index();
+        ReaderSlot &slot = readers_[index];
+        if(index != OVERFLOW) {
+            if(slot.depth++ == 0) slot.epoch.store(global_.load());
+            return Guard{*this, slot};
+        }
+        std::scoped_lock<std::mutex> lock{overflow_mtx_};
+        if(slot.depth++ == 0) slot.epoch.store(global_.load());
+        return Guard{*this, slot};
+    }
+
+    // call after the object has been unlinked from every shared pointer readers can load it from
+    template<typename T>
+    void retire(const T *object)
+    {
+        std::scoped_lock<std::mutex> lock{retire_mtx_};
+        retired_.push_back(Retired{global_.fetch_add(1), [object] { delete object; }});
+        reclaim();
+    }
+
+    // frees what became unreachable since the last retire, returns how many objects are still pending
+    size_t collect()
+    {
+        std::scoped_lock<std::mutex> lock{retire_mtx_};
+        reclaim();
+        return retired_.size();
+    }
+};
@@ -0,0 +1,100 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "parking_lot.hpp"
+
+/*
+    Cost of capacity alerts on the park/unpark path: 64k compact slots over 16 zones, 1..16 gate threads,
+    each keeping its share of the lot half full and then unparking a random vehicle of its own and parking
+    a new one per operation (as bench_zones).
+    alerts_off -> occupancy counters only
+    alerts_on  -> setCapacityAlert(0.9, 0.8) with one subscribed observer: the gates sum the counters every
+                  few operations, the lot never gets near the mark, so nothing fires
+    at_mark    -> high mark just under the fill level (0.49 / 0.45): occupancy hovers right above it, the
+                  hysteresis band lets it fire once on the way up and clear once when the gates drain
+
+    build: g++ -std=c++20 -O2 -pthread bench_alerts.cc -o bench_alerts
+*/
+
+static constexpr size_t SLOTS = 1 << 16;
+static constexpr size_t ZONES = 16;
+static constexpr double SECONDS = 0.5;
+
+struct AlertCount : Observer<ParkingLot>
+{
+    std::atomic<size_t> fired{0};
+
+    void field_changed(ParkingLot&, FieldId) override
+    {
+        fired.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+static double run(size_t threads, double high, double low, size_t &alerts)
+{
+    ParkingLot lot;
+    std::vector<ZoneConfig> configs(ZONES);
+    for(size_t z = 0; z < ZONES; ++z) {
+        configs[z].slots[static_cast<size_t>(SlotSize::Compact)] = SLOTS / ZONES;
+        configs[z].offset = static_cast<uint32_t>(z * 10);
+    }
+    lot.addFloor(configs);
+    for(size_t z = 1; z < ZONES; ++z) lot.addGate(Position{0, static_cast<uint32_t>(z * 10)});
+
+    AlertCount observer;
+    lot.subscribe(observer);
+    if(high > 0) lot.setCapacityAlert(high, low);
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> ops{0};
+    std::vector<std::thread> pool;
+    for(size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            auto car = VehicleFactory::createVehicle(VehicleType::Car, "BENCH" + std::to_string(t));
+            std::mt19937 rng{static_cast<unsigned>(t)};
+            std::vector<size_t> mine;
+            for(size_t i = 0; i < SLOTS / threads / 2; ++i) {
+                if(auto slot = lot.ParkVehcile(car, t % ZONES)) mine.push_back(*slot);
+            }
+            size_t done = 0;
+            while(!stop.load(std::memory_order_relaxed)) {
+                for(size_t i = 0; i < 64; ++i, ++done) {
+                    size_t victim = rng() % mine.size();
+                    lot.UnparkVehicle(mine[victim]);
+                    mine[victim] = *lot.ParkVehcile(car, t % ZONES);
+                }
+            }
+            for(size_t slot : mine) lot.UnparkVehicle(slot);
+            VehicleFactory::destroyVehicle(car);
+            ops += done;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(SECONDS));
+    stop = true;
+    for(auto &th : pool) th.join();
+    lot.unsubscribe(observer);
+    alerts = observer.fired;
+    return ops / SECONDS;
+}
+
+int main()
+{
+    std::cout << "gates,alerts_off_ops_per_sec,alerts_on_ops_per_sec,at_mark_ops_per_sec,at_mark_alerts\n";
+    for(size_t threads : {1, 2, 4, 8, 16}) {
+        size_t off_alerts, on_alerts, at_mark_alerts;
+        double off = run(threads, 0, 0, off_alerts);
+        double on = run(threads, 0.9, 0.8, on_alerts);
+        double at_mark = run(threads, 0.49, 0.45, at_mark_alerts);
+        std::cout << threads << "," << off << "," << on << "," << at_mark << "," << at_mark_alerts << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "parking_slot.hpp"
+#include "free_bitmap.hpp"
+
+/*
+    Park/unpark throughput at steady occupancy: every operation unparks a random parked vehicle and parks a
+    new one, so the lot stays at 10%, 90% or 99.9% full.
+    linear_scan -> walk the slot vector for the first !isOccupied() slot (the obvious ParkVehcile)
+    free_bitmap -> FreeBitmap::acquire / release
+
+    build: g++ -std=c++20 -O2 bench_allocator.cc -o bench_allocator
+*/
+
+static constexpr size_t SLOTS = 1'000'000;
+static constexpr double SECONDS = 1.0;
+
+struct LinearScan
+{
+    std::vector<ParkingSlot> slots{SLOTS};
+    std::shared_ptr<Vehicle> car = std::make_shared<Car>("BENCH");
+
+    std::optional<size_t> park()
+    {
+        for(size_t i = 0; i < slots.size(); ++i) {
+            if(!slots[i].isOccupied()) {
+                slots[i].OccupySlot(car);
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+    void unpark(size_t i) { slots[i].FreeSlot(); }
+
+    // initial fill without the O(n^2) of n scanning parks
+    void fill(size_t n) { for(size_t i = 0; i < n; ++i) slots[i].OccupySlot(car); }
+};
+
+struct Bitmap
+{
+    FreeBitmap free{SLOTS};
+
+    std::optional<size_t> park() { return free.acquire(); }
+    void unpark(size_t i) { free.release(i); }
+
+    void fill(size_t n) { for(size_t i = 0; i < n; ++i) free.acquire(); }
+};
+
+template<typename Lot>
+double run(double occupancy)
+{
+    Lot lot;
+    std::vector<size_t> parked;
+    const size_t target = static_cast<size_t>(SLOTS * occupancy);
+    lot.fill(target);
+    for(size_t i = 0; i < target; ++i) parked.push_back(i);
+
+    // time bounded, the linear scan is far too slow for a fixed operation count at low occupancy
+    std::mt19937_64 rng{5};
+    size_t ops = 0;
+    double elapsed = 0;
+    auto start = std::chrono::steady_clock::now();
+    while(elapsed < SECONDS) {
+        for(size_t i = 0; i < 64; ++i, ++ops) {
+            size_t victim = rng() % parked.size();
+            lot.unpark(parked[victim]);
+            parked[victim] = *lot.park();
+        }
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return ops / elapsed;
+}
+
+int main()
+{
+    std::cout << "occupancy,linear_scan_ops_per_sec,free_bitmap_ops_per_sec\n";
+    for(double occupancy : {0.10, 0.90, 0.999}) {
+        std::cout << occupancy << "," << run<LinearScan>(occupancy) << "," << run<Bitmap>(occupancy) << "\n";
+    }
+    return 0;
+}
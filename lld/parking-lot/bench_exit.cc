@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "slot_pool.hpp"
+#include "parking_lot.hpp"
+
+/*
+    Exit latency at a full 1M slot lot: a random parked plate leaves and a new car takes its slot, so the lot
+    stays full. Only the lookup + unpark of the leaving vehicle is timed.
+    scan        -> walk every slot comparing getRegNo() with the plate, then unpark (what the exit had to do
+                   without an index), on a 1M slot SlotPool
+    plate_index -> ParkingLot::ExitVehicle: one PlateIndex probe, then the slot's zone
+
+    build: g++ -std=c++20 -O2 -pthread bench_exit.cc -o bench_exit
+*/
+
+static constexpr size_t SLOTS = 1'000'000;
+static constexpr size_t ZONES = 16;
+static constexpr size_t SCAN_EXITS = 200;
+static constexpr size_t INDEX_EXITS = 1'000'000;
+
+static std::string plate(size_t n)
+{
+    return "KA" + std::to_string(10'000'000 + n);
+}
+
+static void report(const char *name, std::vector<double> &ns)
+{
+    std::sort(ns.begin(), ns.end());
+    auto at = [&](double q) { return ns[static_cast<size_t>(q * (ns.size() - 1))]; };
+    std::cout << name << "," << ns.size() << "," << at(0.5) << "," << at(0.99) << "," << at(0.999) << "\n";
+}
+
+int main()
+{
+    using clock = std::chrono::steady_clock;
+    std::mt19937_64 rng{20};
+
+    // scan baseline on the slot arrays: vehicle i sits in slot i
+    std::vector<double> scan_ns;
+    {
+        SlotPool pool{SlotSize::Compact, SLOTS, 1};
+        std::vector<VehicleRef> parked(SLOTS);
+        for(size_t i = 0; i < SLOTS; ++i) {
+            parked[i] = VehicleFactory::createVehicle(VehicleType::Car, plate(i));
+            pool.park(parked[i], i);
+        }
+        size_t next = SLOTS;
+        for(size_t e = 0; e < SCAN_EXITS; ++e) {
+            std::string leaving{parked[rng() % SLOTS]->getRegNo()};
+            auto start = clock::now();
+            size_t idx = 0;
+            while(idx < SLOTS && pool.vehicle(idx)->getRegNo() != leaving) ++idx;
+            VehicleRef vehicle = pool.unpark(idx);
+            scan_ns.push_back(std::chrono::duration<double, std::nano>(clock::now() - start).count());
+
+            VehicleFactory::destroyVehicle(vehicle);
+            parked[idx] = VehicleFactory::createVehicle(VehicleType::Car, plate(next++));
+            pool.park(parked[idx], idx);
+        }
+        for(size_t i = 0; i < SLOTS; ++i) VehicleFactory::destroyVehicle(pool.unpark(i));
+    }
+
+    // plate index on a full ParkingLot
+    std::vector<double> index_ns;
+    {
+        ParkingLot lot;
+        std::vector<ZoneConfig> zones(ZONES);
+        for(auto &zone : zones) zone.slots[static_cast<size_t>(SlotSize::Compact)] = SLOTS / ZONES;
+        lot.addFloor(zones);
+
+        std::vector<std::string> parked;
+        for(size_t i = 0; i < SLOTS; ++i) {
+            parked.push_back(plate(i));
+            lot.EnterVehicle(VehicleFactory::createVehicle(VehicleType::Car, parked.back()));
+        }
+        size_t next = SLOTS;
+        for(size_t e = 0; e < INDEX_EXITS; ++e) {
+            std::string &leaving = parked[rng() % SLOTS];
+            auto start = clock::now();
+            auto departure = lot.ExitVehicle(leaving);
+            index_ns.push_back(std::chrono::duration<double, std::nano>(clock::now() - start).count());
+
+            VehicleFactory::destroyVehicle(departure->vehicle);
+            leaving = plate(next++);
+            lot.EnterVehicle(VehicleFactory::createVehicle(VehicleType::Car, leaving));
+        }
+        if(lot.getAvailableSlots() != 0) std::cout << "lot not full\n";
+    }
+
+    std::cout << "exit,samples,p50_ns,p99_ns,p999_ns\n";
+    report("scan", scan_ns);
+    report("plate_index", index_ns);
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "slot_pool.hpp"
+#include "reservation.hpp"
+
+/*
+    Pre-booking throughput over a two day calendar of 15 minute buckets, lots of 16k, 128k and 1M slots split
+    over the size classes like the default lot. Bookings are for random vehicle types (mostly cars), start
+    anywhere in the calendar and last 30 minutes to 8 hours; the lot is booked until about 60% of all
+    slot-buckets are taken (~8 bookings per slot, thousands per slot class and bucket).
+    book         -> ReservationBook::book while filling the calendar, one thread
+    bitmap_find  -> ReservationBook::find for random 1 to 12 hour windows on the filled calendar
+    scan_find    -> the same queries against every slot's sorted list of booked intervals, slot by slot
+                    (a binary search per slot); both must agree on which queries find a slot
+    Then 1..8 threads book and cancel random windows on the filled 128k calendar (churn_ops_per_sec).
+
+    build: g++ -std=c++20 -O2 -pthread bench_reservations.cc -o bench_reservations
+*/
+
+static constexpr size_t BUCKETS = 2 * 24 * 4;
+static constexpr double FILL = 0.6;
+static constexpr size_t QUERIES = 20'000;
+static constexpr double SCAN_SECONDS = 2.0;
+static constexpr double CHURN_SECONDS = 0.5;
+
+using Interval = std::pair<uint32_t, uint32_t>;         // first, last bucket
+
+struct Query
+{
+    VehicleType type;
+    uint32_t from, to;
+};
+
+static VehicleType random_type(std::mt19937_64 &rng)
+{
+    static constexpr VehicleType MIX[10] = {VehicleType::Motorcycle, VehicleType::Motorcycle, VehicleType::Car,
+                                            VehicleType::Car, VehicleType::Car, VehicleType::Car, VehicleType::Car,
+                                            VehicleType::Car, VehicleType::Truck, VehicleType::Bus};
+    return MIX[rng() % 10];
+}
+
+static Query random_window(std::mt19937_64 &rng, uint32_t min_seconds, uint32_t max_seconds)
+{
+    const uint32_t horizon = BUCKETS * ReservationBook::QUARTER_HOUR;
+    uint32_t length = min_seconds + static_cast<uint32_t>(rng() % (max_seconds - min_seconds + 1));
+    uint32_t from = static_cast<uint32_t>(rng() % (horizon - length));
+    return Query{random_type(rng), from, from + length};
+}
+
+static std::array<size_t, SLOT_SIZE_COUNT> split(size_t slots)
+{
+    std::array<size_t, SLOT_SIZE_COUNT> sizes{slots / 5, slots * 3 / 5, slots * 3 / 20, 0};
+    sizes[3] = slots - sizes[0] - sizes[1] - sizes[2];
+    return sizes;
+}
+
+// the interval-list baseline: free if no booked interval overlaps first..last
+static bool free_in(const std::vector<Interval> &booked, uint32_t first, uint32_t last)
+{
+    auto it = std::upper_bound(booked.begin(), booked.end(), Interval{last, UINT32_MAX});
+    return it == booked.begin() || std::prev(it)->second < first;
+}
+
+static bool scan_find(const std::array<std::vector<std::vector<Interval>>, SLOT_SIZE_COUNT> &calendar,
+                      const Query &q)
+{
+    uint32_t first = q.from / ReservationBook::QUARTER_HOUR, last = (q.to - 1) / ReservationBook::QUARTER_HOUR;
+    for(size_t c = static_cast<size_t>(slot_size_for(q.type)); c < SLOT_SIZE_COUNT; ++c) {
+        for(auto &booked : calendar[c]) {
+            if(free_in(booked, first, last)) return true;
+        }
+    }
+    return false;
+}
+
+template<typename F>
+static double seconds(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void churn(ReservationBook &book, std::ostream &out)
+{
+    for(size_t threads : {1, 2, 4, 8}) {
+        std::atomic<bool> stop{false};
+        std::atomic<size_t> ops{0};
+        std::vector<std::thread> pool;
+        for(size_t t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                std::mt19937_64 rng{100 + t};
+                std::vector<Reservation> mine;
+                size_t done = 0;
+                while(!stop.load(std::memory_order_relaxed)) {
+                    if(mine.size() > 64 || (!mine.empty() && rng() % 2)) {
+                        size_t i = rng() % mine.size();
+                        book.cancel(mine[i]);
+                        mine[i] = mine.back();
+                        mine.pop_back();
+                    }
+                    else {
+                        auto q = random_window(rng, 30 * 60, 8 * 3600);
+                        if(auto r = book.book(q.type, q.from, q.to, t * 4096)) mine.push_back(*r);
+                    }
+                    ++done;
+                }
+                for(auto &r : mine) book.cancel(r);
+                ops += done;
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(CHURN_SECONDS));
+        stop = true;
+        for(auto &th : pool) th.join();
+        out << threads << "," << ops / CHURN_SECONDS << "\n";
+    }
+}
+
+int main()
+{
+    std::ostringstream churn_out;
+    std::cout << "slots,bookings,book_per_sec,bitmap_find_per_sec,scan_find_per_sec,found_pct,agree,memory_mb\n";
+    for(size_t slots : {size_t{1} << 14, size_t{1} << 17, size_t{1} << 20}) {
+        auto sizes = split(slots);
+        ReservationBook book{sizes, ReservationBook::QUARTER_HOUR, BUCKETS};
+        std::array<std::vector<std::vector<Interval>>, SLOT_SIZE_COUNT> calendar;
+        for(size_t c = 0; c < SLOT_SIZE_COUNT; ++c) calendar[c].resize(sizes[c]);
+
+        // fill: mean stay 4h15m = 17 buckets
+        std::mt19937_64 rng{24};
+        const size_t attempts = static_cast<size_t>(FILL * slots * BUCKETS / 17);
+        std::vector<Reservation> booked;
+        booked.reserve(attempts);
+        double fill_time = seconds([&] {
+            for(size_t i = 0; i < attempts; ++i) {
+                auto q = random_window(rng, 30 * 60, 8 * 3600);
+                if(auto r = book.book(q.type, q.from, q.to, i)) booked.push_back(*r);
+            }
+        });
+        for(auto &r : booked) {
+            calendar[static_cast<size_t>(r.size)][r.slot].push_back(Interval{r.first, r.last});
+        }
+        for(auto &by_class : calendar) {
+            for(auto &intervals : by_class) std::sort(intervals.begin(), intervals.end());
+        }
+
+        std::vector<Query> queries(QUERIES);
+        for(auto &q : queries) q = random_window(rng, 3600, 12 * 3600);
+        std::vector<char> found(QUERIES);
+        double find_time = seconds([&] {
+            for(size_t i = 0; i < QUERIES; ++i) {
+                found[i] = book.find(queries[i].type, queries[i].from, queries[i].to).has_value();
+            }
+        });
+
+        // the scan gets a time budget, it is checked against the bitmap on the queries it got through
+        size_t scanned = 0;
+        bool agree = true;
+        double scan_time = seconds([&] {
+            auto start = std::chrono::steady_clock::now();
+            for(; scanned < QUERIES; ++scanned) {
+                if(scan_find(calendar, queries[scanned]) != static_cast<bool>(found[scanned])) agree = false;
+                if(scanned % 64 == 0 &&
+                   std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > SCAN_SECONDS) {
+                    ++scanned;
+                    break;
+                }
+            }
+        });
+
+        size_t hits = static_cast<size_t>(std::count(found.begin(), found.end(), 1));
+        std::cout << slots << "," << booked.size() << "," << attempts / fill_time << "," << QUERIES / find_time << ","
+                  << scanned / scan_time << "," << 100.0 * hits / QUERIES << "," << (agree ? "yes" : "NO") << ","
+                  << book.memory_bytes() / 1e6 << "\n";
+
+        if(slots == size_t{1} << 17) churn(book, churn_out);
+    }
+    std::cout << "threads,churn_ops_per_sec\n" << churn_out.str();
+    return 0;
+}
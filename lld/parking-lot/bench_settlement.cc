@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "fee_calculator.hpp"
+#include "ticket_store.hpp"
+
+/*
+    End-of-day settlement throughput over 10M closed tickets of one day, random vehicle types and stays.
+    per_ticket -> one ticket object per stay (id, times, slot, type), one FeeCalculator::fee call each
+    columnar   -> TicketStore::settle: one virtual batch call per 64k ticket chunk over packed columns
+    Both are run with FixedRateFeeCalculator and TimeBasedFeeCalculator and must agree on the revenue.
+
+    build: g++ -std=c++20 -O3 -march=native bench_settlement.cc -o bench_settlement
+*/
+
+static constexpr size_t TICKETS = 10'000'000;
+static constexpr int ROUNDS = 5;
+
+struct TicketRecord
+{
+    uint64_t id;
+    uint32_t entry;
+    uint32_t exit;
+    size_t slot;
+    VehicleType type;
+};
+
+template<typename Pass>
+double tickets_per_sec(Pass pass, uint64_t &revenue)
+{
+    auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < ROUNDS; ++r) revenue = pass();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return ROUNDS * TICKETS / elapsed;
+}
+
+int main()
+{
+    std::mt19937_64 rng{21};
+    std::exponential_distribution<double> stay{1.0 / 7200};         // mean two hours
+
+    TicketStore store;
+    std::vector<TicketRecord> records;
+    records.reserve(TICKETS);
+    for(size_t i = 0; i < TICKETS; ++i) {
+        auto type = static_cast<VehicleType>(rng() % VEHICLE_TYPE_COUNT);
+        auto entry = static_cast<uint32_t>(rng() % TicketStore::DAY);
+        auto exit = entry + static_cast<uint32_t>(stay(rng));
+        uint64_t id = store.issue(i % 1'000'000 + 1, type, entry);
+        store.close(id, exit);
+        records.push_back(TicketRecord{id, entry, exit, i % 1'000'000 + 1, type});
+    }
+    auto [first, last] = store.day_range(0);
+
+    FixedRateFeeCalculator fixed{{500, 200, 1500, 2000}};
+    TimeBasedFeeCalculator hourly{{100, 40, 300, 400}, {1200, 500, 3600, 4800}};
+
+    std::cout << "strategy,per_ticket_per_sec,columnar_per_sec,revenue_match\n";
+    for(auto [name, calculator] : {std::pair<const char*, const FeeCalculator*>{"fixed_rate", &fixed},
+                                   std::pair<const char*, const FeeCalculator*>{"time_based", &hourly}}) {
+        uint64_t object_revenue = 0, column_revenue = 0;
+        double object_rate = tickets_per_sec([&] {
+            uint64_t revenue = 0;
+            for(auto &ticket : records) revenue += calculator->fee(ticket.entry, ticket.exit, ticket.type);
+            return revenue;
+        }, object_revenue);
+        double column_rate = tickets_per_sec([&] { return store.settle(first, last, *calculator).revenue; },
+                                             column_revenue);
+        std::cout << name << "," << object_rate << "," << column_rate << ","
+                  << (object_revenue == column_revenue ? "yes" : "NO") << "\n";
+    }
+    return 0;
+}
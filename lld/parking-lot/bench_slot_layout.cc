@@ -0,0 +1,102 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "parking_slot.hpp"
+#include "free_bitmap.hpp"
+#include "slot_pool.hpp"
+
+/*
+    Slot storage layout on a 1M slot lot, half full with a random mix of vehicle types.
+    object_per_slot -> std::vector<ParkingSlot> (ID + shared_ptr<Vehicle> + state) next to a FreeBitmap
+    soa             -> SlotPool: FreeBitmap + one 32-bit VehicleHandle per slot
+
+    Reported: bytes of slot storage per slot (parked Vehicle objects themselves not counted), and how fast an
+    occupancy report (parked vehicles per VehicleType) scans the lot.
+
+    build: g++ -std=c++20 -O2 bench_slot_layout.cc -o bench_slot_layout
+*/
+
+static constexpr size_t SLOTS = 1'000'000;
+static constexpr double SECONDS = 1.0;
+
+template<typename Scan>
+double slots_scanned_per_sec(Scan scan)
+{
+    size_t scans = 0;
+    double elapsed = 0;
+    auto start = std::chrono::steady_clock::now();
+    while(elapsed < SECONDS) {
+        scan();
+        ++scans;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return scans * SLOTS / elapsed;
+}
+
+int main()
+{
+    std::mt19937_64 rng{18};
+    std::vector<bool> parked(SLOTS);
+    std::vector<VehicleRef> vehicles(SLOTS);
+    for(size_t i = 0; i < SLOTS; ++i) {
+        parked[i] = rng() % 2;
+        if(parked[i]) vehicles[i] = VehicleFactory::createVehicle(static_cast<VehicleType>(rng() % 4), "B");
+    }
+
+    // the baseline slot owns its vehicle through a shared_ptr; the type is all the scan looks at
+    auto shared_copy = [](VehicleRef vehicle) -> std::shared_ptr<Vehicle> {
+        switch(vehicle.type())
+        {
+        case VehicleType::Car: return std::make_shared<Car>("B");
+        case VehicleType::Motorcycle: return std::make_shared<Motorcycle>("B");
+        case VehicleType::Truck: return std::make_shared<Truck>("B");
+        case VehicleType::Bus: return std::make_shared<Bus>("B");
+        }
+        return nullptr;
+    };
+
+    // object per slot
+    std::vector<ParkingSlot> objects(SLOTS);
+    FreeBitmap object_free{SLOTS};
+    for(size_t i = 0; i < SLOTS; ++i) {
+        if(!parked[i]) continue;
+        object_free.claim(i);
+        objects[i].OccupySlot(shared_copy(vehicles[i]));
+    }
+    std::array<size_t, VEHICLE_TYPE_COUNT> object_counts{};
+    auto object_scan = [&] {
+        object_counts = {};
+        for(auto &slot : objects) {
+            if(slot.isOccupied()) ++object_counts[static_cast<size_t>(slot.getVehicle()->getVehicleType())];
+        }
+    };
+
+    // struct of arrays, filled in slot order so index i holds vehicles[i]
+    SlotPool pool{SlotSize::XLarge, SLOTS, 1};
+    auto placeholder = VehicleFactory::createVehicle(VehicleType::Car, "P");
+    for(size_t i = 0; i < SLOTS; ++i) pool.park(vehicles[i] ? vehicles[i] : placeholder, 0);
+    for(size_t i = 0; i < SLOTS; ++i) {
+        if(!parked[i]) pool.unpark(i);
+    }
+    std::array<size_t, VEHICLE_TYPE_COUNT> soa_counts{};
+    auto soa_scan = [&] {
+        soa_counts = {};
+        pool.count_by_type(soa_counts);
+    };
+
+    double object_bytes = (sizeof(ParkingSlot) * SLOTS + object_free.memory_bytes()) / double(SLOTS);
+    double soa_bytes = pool.memory_bytes() / double(SLOTS);
+    double object_rate = slots_scanned_per_sec(object_scan);
+    double soa_rate = slots_scanned_per_sec(soa_scan);
+
+    std::cout << "layout,bytes_per_slot,report_slots_per_sec,cars_parked\n";
+    std::cout << "object_per_slot," << object_bytes << "," << object_rate << "," << object_counts[0] << "\n";
+    std::cout << "soa," << soa_bytes << "," << soa_rate << "," << soa_counts[0] << "\n";
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vehicle.hpp"
+
+/*
+    Vehicle create/destroy throughput at a steady population: every gate thread keeps WORKING vehicles alive
+    and per operation destroys a random one and creates a new one in its place, the way arrivals and exits
+    churn the lot.
+    make_shared -> std::make_shared<Car>(std::string) per arrival, released with the last shared_ptr
+    pooled     -> VehicleFactory::createVehicle / destroyVehicle on the per-type SlabPool
+
+    build: g++ -std=c++20 -O2 -pthread bench_vehicle_pool.cc -o bench_vehicle_pool
+*/
+
+static constexpr size_t WORKING = 4096;
+static constexpr double SECONDS = 0.5;
+
+// the registration number arrives as a std::string (scanner / ticket input), built once per arrival
+static std::string plate(size_t n)
+{
+    return "KA01AB" + std::to_string(n % 10000);
+}
+
+struct SharedCars
+{
+    std::vector<std::shared_ptr<Vehicle>> live;
+
+    void create(size_t i, size_t n) { live[i] = std::make_shared<Car>(plate(n)); }
+    void destroy(size_t i) { live[i].reset(); }
+};
+
+struct PooledCars
+{
+    std::vector<VehicleRef> live;
+
+    void create(size_t i, size_t n) { live[i] = VehicleFactory::createVehicle(VehicleType::Car, plate(n)); }
+    void destroy(size_t i) { VehicleFactory::destroyVehicle(live[i]); }
+};
+
+template<typename Cars>
+double run(size_t threads)
+{
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> ops{0};
+    std::vector<std::thread> pool;
+
+    for(size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            Cars cars;
+            cars.live.resize(WORKING);
+            std::mt19937 rng{static_cast<unsigned>(t)};
+            size_t done = 0;
+            for(size_t i = 0; i < WORKING; ++i) cars.create(i, done++);
+            while(!stop.load(std::memory_order_relaxed)) {
+                for(size_t k = 0; k < 64; ++k, ++done) {
+                    size_t i = rng() % WORKING;
+                    cars.destroy(i);
+                    cars.create(i, done);
+                }
+            }
+            for(size_t i = 0; i < WORKING; ++i) cars.destroy(i);
+            ops += done;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(SECONDS));
+    stop = true;
+    for(auto &th : pool) th.join();
+    return ops / SECONDS;
+}
+
+int main()
+{
+    std::cout << "threads,make_shared_ops_per_sec,pooled_ops_per_sec\n";
+    for(size_t threads : {1, 2, 4, 8, 16}) {
+        std::cout << threads << "," << run<SharedCars>(threads) << "," << run<PooledCars>(threads) << "\n";
+    }
+    std::cout << "sizeof(Car)," << sizeof(Car) << ",sizeof(VehicleRef)," << sizeof(VehicleRef) << "\n";
+    return 0;
+}
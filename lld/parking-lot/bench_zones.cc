@@ -0,0 +1,87 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "parking_lot.hpp"
+
+/*
+    Park/unpark throughput of a ParkingLot with the same 64k compact slots either in one zone or sharded over
+    16 zones, with 1..16 gate threads. Each gate keeps half of its share of the lot parked and then unparks a
+    random vehicle of its own and parks a new one per operation.
+    single_zone    -> every gate fights over one set of bitmap words
+    nearest_gate   -> 16 zones, every gate has its own entrance next to one zone (NearestToGateRouter)
+    least_loaded   -> 16 zones, LeastLoadedRouter
+
+    build: g++ -std=c++20 -O2 -pthread bench_zones.cc -o bench_zones
+*/
+
+static constexpr size_t SLOTS = 1 << 16;
+static constexpr size_t ZONES = 16;
+static constexpr double SECONDS = 0.5;
+
+static std::unique_ptr<ParkingLot> make_lot(size_t zones, std::unique_ptr<ZoneRouter> router)
+{
+    auto lot = std::make_unique<ParkingLot>(std::move(router));
+    std::vector<ZoneConfig> configs(zones);
+    for(size_t z = 0; z < zones; ++z) {
+        configs[z].slots[static_cast<size_t>(SlotSize::Compact)] = SLOTS / zones;
+        configs[z].offset = static_cast<uint32_t>(z * 10);
+    }
+    lot->addFloor(configs);
+    for(size_t z = 1; z < ZONES; ++z) lot->addGate(Position{0, static_cast<uint32_t>(z * 10)});
+    return lot;
+}
+
+static double run(ParkingLot &lot, size_t threads)
+{
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> ops{0};
+    std::vector<std::thread> pool;
+
+    for(size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            auto car = VehicleFactory::createVehicle(VehicleType::Car, "BENCH" + std::to_string(t));
+            std::mt19937 rng{static_cast<unsigned>(t)};
+            std::vector<size_t> mine;
+            for(size_t i = 0; i < SLOTS / threads / 2; ++i) {
+                if(auto slot = lot.ParkVehcile(car, t % ZONES)) mine.push_back(*slot);
+            }
+            size_t done = 0;
+            while(!stop.load(std::memory_order_relaxed)) {
+                for(size_t i = 0; i < 64; ++i, ++done) {
+                    size_t victim = rng() % mine.size();
+                    lot.UnparkVehicle(mine[victim]);
+                    mine[victim] = *lot.ParkVehcile(car, t % ZONES);
+                }
+            }
+            for(size_t slot : mine) lot.UnparkVehicle(slot);
+            ops += done;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(SECONDS));
+    stop = true;
+    for(auto &th : pool) th.join();
+    return ops / SECONDS;
+}
+
+int main()
+{
+    auto single = make_lot(1, std::make_unique<NearestToGateRouter>());
+    auto nearest = make_lot(ZONES, std::make_unique<NearestToGateRouter>());
+    auto least = make_lot(ZONES, std::make_unique<LeastLoadedRouter>());
+
+    std::cout << "gates,single_zone_ops_per_sec,nearest_gate_ops_per_sec,least_loaded_ops_per_sec\n";
+    for(size_t threads : {1, 2, 4, 8, 16}) {
+        std::cout << threads << "," << run(*single, threads) << "," << run(*nearest, threads) << ","
+                  << run(*least, threads) << "\n";
+    }
+    return 0;
+}
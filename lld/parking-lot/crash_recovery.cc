@@ -0,0 +1,206 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "vehicle.hpp"
+#include "parking_lot.hpp"
+#include "wal.hpp"
+
+/*
+    Crash test for the write-ahead log: every round forks a child that recovers SingletonParkingLot from the
+    log directory, restores it, attaches a new WriteAheadLog and lets its gate threads park, enter, unpark
+    and exit vehicles (the restored ones included) flat out, while its main thread keeps sending durable_lsn() to
+    the parent. After a seeded random delay the parent kills the child with SIGKILL, mid batch and at times
+    mid snapshot, and checks the directory:
+        - recover() succeeds, reaches at least the last LSN the child reported durable, with no anomaly
+          (no park into a taken slot, no unpark of a free one)
+        - a full replay of every segment, ignoring the snapshot, gives exactly the same lot
+        - no plate is parked twice, no ticket id is held twice and every slot is one of the lot's
+        - a ticketed vehicle that was already there after the previous round still has the same ticket id
+          and entry time
+    The next round's child must then be able to restore every recovered vehicle into its old slot, with its
+    ticket under the same id and entry time. Every gate of the first round also enters one vehicle that
+    stays for the whole test, so by the later rounds restored entry times are seconds old. Segments are kept
+    (keep_segments) so the full replay has them all; snapshots are taken every 4096 records.
+
+    build: g++ -std=c++20 -O2 -pthread crash_recovery.cc -o crash_recovery
+    run:   ./crash_recovery [rounds] [gates] [seed] [dir]
+*/
+
+static constexpr int RESTORE_FAILED = 3;
+
+[[noreturn]] static void run_child(const std::string &dir, size_t round, size_t gates, int report_fd)
+{
+    auto recovered = WriteAheadLog::recover(dir);
+    if(!recovered) _exit(RESTORE_FAILED);
+
+    auto &lot = SingletonParkingLot::getInstance();
+    if(lot.restore(*recovered) != recovered->vehicles.size()) _exit(RESTORE_FAILED);
+    for(auto &v : recovered->vehicles) {
+        if(!v.ticketed) continue;
+        auto ticket = lot.findVehicle(v.plate.view());
+        if(!ticket || ticket->id != v.ticket || lot.tickets().unix_time(lot.tickets().entry(ticket->id)) != v.entry) {
+            _exit(RESTORE_FAILED);
+        }
+    }
+
+    WalOptions options;
+    options.snapshot_every = 4096;
+    options.keep_segments = true;
+    WriteAheadLog wal{dir, *recovered, options};
+    lot.attachLog(&wal);
+
+    std::vector<std::thread> pool;
+    for(size_t g = 0; g < gates; ++g) {
+        pool.emplace_back([&, g] {
+            std::mt19937 rng{static_cast<unsigned>(round * 1000 + g)};
+            struct Parked
+            {
+                size_t slot;
+                std::string plate;
+                bool ticketed;
+            };
+
+            if(round == 1) {
+                auto resident = VehicleFactory::createVehicle(VehicleType::Car, "STAY" + std::to_string(g));
+                if(!lot.EnterVehicle(resident, g)) VehicleFactory::destroyVehicle(resident);
+            }
+
+            // this gate's share of the vehicles left over from the last round, the residents stay
+            std::vector<Parked> mine;
+            for(size_t i = g; i < recovered->vehicles.size(); i += gates) {
+                auto &v = recovered->vehicles[i];
+                if(v.plate.view().starts_with("STAY")) continue;
+                mine.push_back(Parked{v.slot, std::string{v.plate.view()}, v.ticketed});
+            }
+
+            for(size_t n = 0;; ++n) {
+                if(!mine.empty() && (mine.size() > 100 || rng() % 2)) {
+                    size_t i = rng() % mine.size();
+                    Parked parked = mine[i];
+                    mine[i] = mine.back();
+                    mine.pop_back();
+                    VehicleRef vehicle;
+                    if(parked.ticketed) {
+                        if(auto departure = lot.ExitVehicle(parked.plate)) vehicle = departure->vehicle;
+                    }
+                    else vehicle = lot.UnparkVehicle(parked.slot);
+                    VehicleFactory::destroyVehicle(vehicle);
+                    continue;
+                }
+
+                auto plate = "R" + std::to_string(round) + "G" + std::to_string(g) + "N" + std::to_string(n);
+                auto vehicle = VehicleFactory::createVehicle(static_cast<VehicleType>(rng() % 4), plate);
+                bool ticketed = rng() % 2;
+                std::optional<size_t> slot;
+                if(ticketed) {
+                    if(auto ticket = lot.EnterVehicle(vehicle, g)) slot = ticket->slot;
+                }
+                else slot = lot.ParkVehcile(vehicle, g);
+                if(slot) mine.push_back(Parked{*slot, plate, ticketed});
+                else VehicleFactory::destroyVehicle(vehicle);
+            }
+        });
+    }
+
+    for(;;) {
+        uint64_t durable = wal.durable_lsn();
+        if(::write(report_fd, &durable, sizeof(durable)) != sizeof(durable) || wal.failed()) _exit(RESTORE_FAILED);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+static bool same(const LotState &a, const LotState &b)
+{
+    if(a.lsn != b.lsn || a.anomalies != b.anomalies || a.vehicles.size() != b.vehicles.size()) return false;
+    for(size_t i = 0; i < a.vehicles.size(); ++i) {
+        auto &x = a.vehicles[i];
+        auto &y = b.vehicles[i];
+        if(x.slot != y.slot || x.type != y.type || !(x.plate == y.plate) || x.ticketed != y.ticketed ||
+           x.ticket != y.ticket || x.entry != y.entry) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    size_t rounds = argc > 1 ? std::stoul(argv[1]) : 10;
+    size_t gates = argc > 2 ? std::stoul(argv[2]) : 4;
+    unsigned seed = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 23;
+    std::string dir = argc > 4 ? argv[4] : (std::filesystem::temp_directory_path() / "parking_wal_crash").string();
+
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::mt19937 rng{seed};
+    size_t violations = 0;
+    std::map<std::string, std::pair<uint64_t, int64_t>> tickets;        // plate -> ticket id, entry of last round
+
+    std::cout << "round,killed_after_ms,reported_durable,recovered_lsn,parked,violations\n";
+    for(size_t round = 1; round <= rounds; ++round) {
+        int fds[2];
+        if(::pipe(fds) != 0) return 2;
+        pid_t child = ::fork();
+        if(child < 0) return 2;
+        if(child == 0) {
+            ::close(fds[0]);
+            run_child(dir, round, gates, fds[1]);
+        }
+        ::close(fds[1]);
+
+        // the clock starts once the child has recovered and reported for the first time
+        uint64_t reported = 0, durable;
+        if(::read(fds[0], &reported, sizeof(reported)) != sizeof(reported)) ++violations;
+        unsigned delay = 50 + rng() % 250;
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        ::kill(child, SIGKILL);
+        int status = 0;
+        ::waitpid(child, &status, 0);
+
+        while(::read(fds[0], &durable, sizeof(durable)) == sizeof(durable)) reported = durable;
+        ::close(fds[0]);
+
+        size_t bad = 0;
+        if(!WIFSIGNALED(status)) ++bad;         // exited by itself: it could not restore or the log failed
+        auto recovered = WriteAheadLog::recover(dir);
+        auto replayed = WriteAheadLog::recover(dir, false);
+        if(!recovered || !replayed || !same(*recovered, *replayed)) ++bad;
+        if(recovered) {
+            if(recovered->lsn < reported || recovered->anomalies != 0) ++bad;
+            std::set<std::string> plates;
+            std::set<uint64_t> ids;
+            std::map<std::string, std::pair<uint64_t, int64_t>> now;
+            for(auto &v : recovered->vehicles) {
+                std::string plate{v.plate.view()};
+                if(v.slot == 0 || v.slot > PARKING_LOT_SIZE) ++bad;
+                if(!plates.insert(plate).second) ++bad;
+                if(!v.ticketed) continue;
+                if(v.ticket == 0 || v.entry == 0 || !ids.insert(v.ticket).second) ++bad;
+                now[plate] = {v.ticket, v.entry};
+                // plates are never reused, so the same plate is the same stay
+                auto before = tickets.find(plate);
+                if(before != tickets.end() && before->second != now[plate]) ++bad;
+            }
+            tickets = std::move(now);
+        }
+        violations += bad;
+        std::cout << round << "," << delay << "," << reported << "," << (recovered ? recovered->lsn : 0) << ","
+                  << (recovered ? recovered->vehicles.size() : 0) << "," << bad << "\n";
+    }
+
+    std::filesystem::remove_all(dir);
+    return violations == 0 ? 0 : 1;
+}
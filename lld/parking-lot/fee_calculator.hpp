@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "vehicle.hpp"
+#include "slot_pool.hpp"
+
+// per VehicleType (indexed by the enum) amount in cents
+using RateTable = std::array<uint32_t, VEHICLE_TYPE_COUNT>;
+
+// Fee Calculator: Strategy for what a stay costs
+/*
+    The strategy works on whole batches of tickets in the TicketStore's columnar layout: entry and exit in
+    seconds, the VehicleType as one byte. One virtual call covers a whole column chunk and the loop inside is
+    plain arithmetic over packed arrays (rate lookups are selects, not table loads), which the compiler turns
+    into SIMD code. fee() is the same computation for a single exit.
+*/
+struct FeeCalculator
+{
+    virtual ~FeeCalculator() = default;
+
+    // out[i] = fee in cents of the stay entry[i]..exit[i] of a vehicle of type[i]; all spans of equal size
+    virtual void fees(std::span<const uint32_t> entry, std::span<const uint32_t> exit,
+                      std::span<const uint8_t> type, std::span<uint32_t> out) const = 0;
+
+    uint32_t fee(uint32_t entry, uint32_t exit, VehicleType type) const
+    {
+        auto t = static_cast<uint8_t>(type);
+        uint32_t out;
+        fees({&entry, 1}, {&exit, 1}, {&t, 1}, {&out, 1});
+        return out;
+    }
+
+protected:
+    // rates[type] written as a chain of selects so that it vectorizes
+    static uint32_t rate_of(const RateTable &rates, uint8_t type)
+    {
+        uint32_t rate = rates[0];
+        for(uint8_t t = 1; t < VEHICLE_TYPE_COUNT; ++t) rate = type == t ? rates[t] : rate;
+        return rate;
+    }
+};
+
+// One flat amount per stay, by vehicle type
+class FixedRateFeeCalculator : public FeeCalculator
+{
+    RateTable rates_;
+
+public:
+    explicit FixedRateFeeCalculator(const RateTable &rates) : rates_(rates) {}
+
+    void fees(std::span<const uint32_t> entry, std::span<const uint32_t> exit,
+              std::span<const uint8_t> type, std::span<uint32_t> out) const override
+    {
+        (void)entry;
+        (void)exit;
+        const RateTable rates = rates_;
+        for(size_t i = 0; i < out.size(); ++i) out[i] = rate_of(rates, type[i]);
+    }
+};
+
+// Per started hour by vehicle type, each day of the stay capped at a daily maximum
+class TimeBasedFeeCalculator : public FeeCalculator
+{
+    RateTable hourly_;
+    RateTable daily_cap_;
+
+public:
+    static constexpr uint32_t HOUR = 3600;
+    static constexpr uint32_t DAY = 24 * HOUR;
+
+    TimeBasedFeeCalculator(const RateTable &hourly, const RateTable &daily_cap)
+        : hourly_(hourly), daily_cap_(daily_cap)
+    {
+    }
+
+    void fees(std::span<const uint32_t> entry, std::span<const uint32_t> exit,
+              std::span<const uint8_t> type, std::span<uint32_t> out) const override
+    {
+        const RateTable hourly = hourly_, cap = daily_cap_;
+        for(size_t i = 0; i < out.size(); ++i) {
+            uint32_t stay = std::max(exit[i], entry[i]) - entry[i];        // an exit before the entry is no stay
+            uint32_t days = stay / DAY;
+            uint32_t hours = (stay % DAY + HOUR - 1) / HOUR;
+            uint32_t day_cap = rate_of(cap, type[i]);
+            out[i] = days * day_cap + std::min(hours * rate_of(hourly, type[i]), day_cap);
+        }
+    }
+};
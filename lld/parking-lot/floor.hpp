@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "zone.hpp"
+#include "sharded_counter.hpp"
+
+// Parking Floor: a fixed set of zones, built once when the floor is added to the lot
+class Floor
+{
+    uint32_t number_;
+    std::vector<std::unique_ptr<Zone>> zones_;
+    ShardedCounter occupied_;                   // kept by the lot on every park/unpark on this floor
+
+public:
+    // zones get consecutive slot ID ranges starting at first_id
+    Floor(uint32_t number, const std::vector<ZoneConfig> &zones, size_t first_id) : number_(number)
+    {
+        for(auto &config : zones) {
+            zones_.push_back(std::make_unique<Zone>(number, config, first_id));
+            first_id += zones_.back()->slot_count();
+        }
+    }
+
+    size_t slot_count() const
+    {
+        size_t n = 0;
+        for(auto &zone : zones_) n += zone->slot_count();
+        return n;
+    }
+
+    Floor(const Floor&) = delete;
+    Floor& operator=(const Floor&) = delete;
+
+    uint32_t number() const { return number_; }
+    const std::vector<std::unique_ptr<Zone>>& zones() const { return zones_; }
+
+    ShardedCounter& occupied() { return occupied_; }
+    const ShardedCounter& occupied() const { return occupied_; }
+
+    size_t available(SlotSize size) const
+    {
+        size_t n = 0;
+        for(auto &zone : zones_) n += zone->available(size);
+        return n;
+    }
+};
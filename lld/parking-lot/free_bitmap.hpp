@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Hierarchical free-slot bitmap, lock-free
+/*
+    Level 0 has one bit per slot (1 = free). Every level above has one bit per word of the level below,
+    set while that word still has a free bit. Finding a free slot walks from the top word down, taking
+    std::countr_zero of one word per level: O(log64 n), i.e. 4 word reads for 16M slots, no matter how full
+    the lot is.
+
+    Every word is atomic. A slot is claimed by a compare-and-swap that clears its leaf bit, so two threads can
+    never get the same slot, and released with a fetch_or. Summary bits are only hints: a thread that empties
+    a word clears the parent bit and then re-checks the word, putting the bit back if a release slipped in
+    between, and a search that follows a stale set bit into an empty word repairs it and retries.
+
+    acquire() first reserves one unit of free_count, so a thread only searches when a free bit is guaranteed
+    to exist, and a full lot is answered without touching the bitmap. The hint picks where the search starts
+    inside every word (bits are taken in rotated order from the hint's position); threads with different
+    hints, e.g. one cursor per entry gate, spread over different words instead of fighting over the first one.
+*/
+class FreeBitmap
+{
+    std::vector<std::vector<std::atomic<uint64_t>>> levels_;    // levels_[0] = leaves, levels_.back() = single top word
+    size_t size_{0};
+    alignas(64) std::atomic<size_t> free_{0};
+
+    static size_t words_for(size_t bits)
+    {
+        return (bits + 63) / 64;
+    }
+
+    // first set bit of word at or after position start, wrapping around; word must not be 0
+    static size_t pick(uint64_t word, size_t start)
+    {
+        return (std::countr_zero(std::rotr(word, static_cast<int>(start))) + start) % 64;
+    }
+
+    // the word child of level l - 1 has a free bit: make sure every summary above knows
+    void set_summary(size_t l, size_t child)
+    {
+        for(; l < levels_.size(); ++l, child /= 64) {
+            uint64_t old = levels_[l][child / 64].fetch_or(uint64_t{1} << (child % 64));
+            if(old != 0) return;        // parent word was already reachable from above
+        }
+    }
+
+    // the word child of level l - 1 was seen empty: clear its summary bit, unless it has refilled meanwhile
+    void clear_summary(size_t l, size_t child)
+    {
+        for(; l < levels_.size(); ++l, child /= 64) {
+            uint64_t bit = uint64_t{1} << (child % 64);
+            uint64_t old = levels_[l][child / 64].fetch_and(~bit);
+            if(levels_[l - 1][child].load() != 0) {
+                set_summary(l, child);
+                return;
+            }
+            if((old & ~bit) != 0) return;
+        }
+    }
+
+    // one descent from the top, nullopt if it ran into a stale summary (the caller retries)
+    std::optional<size_t> try_acquire(size_t hint)
+    {
+        size_t word = 0;
+        for(size_t l = levels_.size() - 1; l > 0; --l) {
+            uint64_t bits = levels_[l][word].load();
+            if(bits == 0) return std::nullopt;
+            size_t child = word * 64 + pick(bits, (hint >> (6 * l)) % 64);
+            if(levels_[l - 1][child].load() == 0) {
+                clear_summary(l, child);
+                return std::nullopt;
+            }
+            word = child;
+        }
+
+        auto &leaf = levels_[0][word];
+        uint64_t bits = leaf.load();
+        while(bits != 0) {
+            size_t b = pick(bits, hint % 64);
+            uint64_t next = bits & ~(uint64_t{1} << b);
+            if(leaf.compare_exchange_weak(bits, next)) {
+                if(next == 0 && levels_.size() > 1) clear_summary(1, word);
+                return word * 64 + b;
+            }
+        }
+        if(levels_.size() > 1) clear_summary(1, word);
+        return std::nullopt;
+    }
+
+    bool reserve()
+    {
+        size_t n = free_.load();
+        do {
+            if(n == 0) return false;
+        } while(!free_.compare_exchange_weak(n, n - 1));
+        return true;
+    }
+
+public:
+    // all n slots start free
+    explicit FreeBitmap(size_t n) : size_(n), free_(n)
+    {
+        size_t bits = n;
+        do {
+            std::vector<std::atomic<uint64_t>> level(std::max<size_t>(words_for(bits), 1));
+            for(auto &w : level) w.store(~uint64_t{0}, std::memory_order_relaxed);
+            if(bits % 64) level.back().store((uint64_t{1} << (bits % 64)) - 1, std::memory_order_relaxed);
+            if(bits == 0) level.back().store(0, std::memory_order_relaxed);
+            levels_.push_back(std::move(level));
+            bits = levels_.back().size();
+        } while(bits > 1);
+    }
+
+    FreeBitmap(const FreeBitmap&) = delete;
+    FreeBitmap& operator=(const FreeBitmap&) = delete;
+
+    // claims a free slot, searching from hint (0 -> lowest first), nullopt if none is left
+    std::optional<size_t> acquire(size_t hint = 0)
+    {
+        if(!reserve()) return std::nullopt;
+        if(hint >= size_) hint %= size_;
+
+        // the reservation guarantees a free bit, a failed descent only met a summary being updated
+        for(;;) {
+            if(auto slot = try_acquire(hint)) return slot;
+        }
+    }
+
+    // claims slot i, false if it is not free
+    bool claim(size_t i)
+    {
+        if(!reserve()) return false;
+
+        auto &leaf = levels_[0][i / 64];
+        uint64_t bit = uint64_t{1} << (i % 64);
+        uint64_t old = leaf.fetch_and(~bit);
+        if(!(old & bit)) {
+            free_.fetch_add(1);         // somebody else owns it, hand the reservation back
+            return false;
+        }
+        if((old & ~bit) == 0 && levels_.size() > 1) clear_summary(1, i / 64);
+        return true;
+    }
+
+    // frees slot i, false if it was already free
+    bool release(size_t i)
+    {
+        uint64_t bit = uint64_t{1} << (i % 64);
+        uint64_t old = levels_[0][i / 64].fetch_or(bit);
+        if(old & bit) return false;
+        if(old == 0 && levels_.size() > 1) set_summary(1, i / 64);
+        free_.fetch_add(1);
+        return true;
+    }
+
+    bool is_free(size_t i) const
+    {
+        return (levels_[0][i / 64].load() >> (i % 64)) & 1;
+    }
+
+    // raw leaf words (bit set = free), for scans over the occupancy
+    size_t word_count() const { return levels_[0].size(); }
+    uint64_t word(size_t w) const { return levels_[0][w].load(std::memory_order_relaxed); }
+
+    size_t memory_bytes() const
+    {
+        size_t words = 0;
+        for(auto &level : levels_) words += level.size();
+        return words * sizeof(uint64_t) + sizeof(*this);
+    }
+
+    size_t size() const { return size_; }
+    size_t free_count() const { return free_.load(); }
+};
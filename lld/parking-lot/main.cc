@@ -1,45 +1,9 @@
-#include <cstddef>
+#include <array>
 #include <iostream>
-#include <vector>
-#include <memory>
 
 #include "vehicle.hpp"
-#include "parking_slot.hpp"
-
-static const size_t PARKING_LOT_SIZE = 1000;
-
-
-size_t ParkingSlot::counter_{0};
-
-
-// Parking Lot Class
-class SingletonParkingLot
-{
-private:
-    SingletonParkingLot()
-    {
-        parking_lot_.resize(PARKING_LOT_SIZE);
-    }
-
-    size_t idx = 0;
-    std::vector<ParkingSlot> parking_lot_;
-
-public:
-    static SingletonParkingLot& getInstance()
-    {
-        // Thread safe Meyer's singleton
-        static SingletonParkingLot instance;
-        return instance;
-    }
-
-    void ParkVehcile(std::shared_ptr<Vehicle> vehicle)
-    {
-
-    }
-
-    SingletonParkingLot(SingletonParkingLot const&) = delete;
-    SingletonParkingLot& operator=(SingletonParkingLot const&) = delete;
-};
+#include "parking_lot.hpp"
+#include "reservation.hpp"
 
 
 int main()
@@ -47,5 +11,32 @@ int main()
     auto car = VehicleFactory::createVehicle(VehicleType::Car, "UP12376");
     std::cout << "Vehicle of type car has reg No: "  << car->getRegNo() << std::endl;
 
-    SingletonParkingLot::getInstance().ParkVehcile(car);
+    auto &lot = SingletonParkingLot::getInstance();
+    auto slot = lot.ParkVehcile(car);
+    if(slot) std::cout << "Parked in slot " << *slot << ", " << lot.getAvailableSlots() << " slots left" << std::endl;
+
+    auto occupancy = lot.getOccupancy(SlotSize::Compact);
+    std::cout << "Compact slots: " << occupancy.occupied << "/" << occupancy.capacity << " occupied" << std::endl;
+
+    // the lot only refers to the vehicle: once it has left, the vehicle goes back to its pool explicitly
+    if(slot) lot.UnparkVehicle(*slot);
+    VehicleFactory::destroyVehicle(car);
+    std::cout << "Left, " << lot.getAvailableSlots() << " slots free" << std::endl;
+
+    // pre-booking: the book counts slots per size class, slotOfClass turns its index into the lot's slot ID
+    std::array<size_t, SLOT_SIZE_COUNT> per_class;
+    for(size_t c = 0; c < SLOT_SIZE_COUNT; ++c) per_class[c] = lot.getOccupancy(static_cast<SlotSize>(c)).capacity;
+    ReservationBook book{per_class};
+    auto booking = book.book(VehicleType::Car, 33 * 3600, 35 * 3600);       // tomorrow 09:00 - 11:00
+    if(!booking) return 1;
+    size_t booked = *lot.slotOfClass(booking->size, booking->slot);
+    std::cout << "Booked slot " << booked << " for tomorrow 09:00-11:00" << std::endl;
+
+    // 09:00 the gate holds the slot, the guest arrives and parks in it, and leaves at 11:00
+    if(!lot.holdSlot(booked)) return 1;
+    auto guest = VehicleFactory::createVehicle(VehicleType::Car, "KA01AB1234");
+    lot.ParkReserved(guest, booked);
+    std::cout << "Guest parked in slot " << booked << ", " << lot.getAvailableSlots() << " slots free" << std::endl;
+    lot.UnparkVehicle(booked);
+    VehicleFactory::destroyVehicle(guest);
 }
@@ -0,0 +1,564 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "slot_pool.hpp"
+#include "zone.hpp"
+#include "floor.hpp"
+#include "zone_router.hpp"
+#include "plate_index.hpp"
+#include "ticket_store.hpp"
+#include "sharded_counter.hpp"
+#include "wal.hpp"
+#include "../../observer/observer.hpp"
+#include "../../observer/cow_observable.hpp"
+
+// slots per size class (Small, Compact, Large, XLarge) of the singleton's ground floor, split over two zones
+static constexpr std::array<size_t, SLOT_SIZE_COUNT> SLOTS_PER_SIZE = {200, 600, 150, 50};
+static const size_t PARKING_LOT_SIZE = SLOTS_PER_SIZE[0] + SLOTS_PER_SIZE[1] + SLOTS_PER_SIZE[2] + SLOTS_PER_SIZE[3];
+
+
+// Parking Lot Class
+/*
+    Composite: ParkingLot -> Floor -> Zone -> one SlotPool per size class. Every zone is a shard with its own
+    lock-free bitmaps, and a pluggable ZoneRouter decides in which order an arriving vehicle tries the zones
+    (nearest to its entry gate, least loaded, ...). Gates sent to different zones never share a cache line,
+    so allocation scales with the number of gate threads instead of serialising on one bitmap.
+
+    A vehicle takes a slot of its own size class in the first zone that has one; only when no zone has one
+    does it fall back to the next larger class, and so on. Smaller classes are never looked at.
+
+    Floors can be added while gates are parking. Existing floors and zones never move: a new floor's zones
+    are appended to a fixed capacity directory and published with one atomic store of the zone count, so
+    readers see either the old set or the new one. Slot IDs keep increasing across floors, and an ID maps
+    back to its zone with a binary search over the directory.
+
+    Safe to call from any number of entry/exit gate threads without a lock: the bitmap hands every free slot
+    to exactly one parker, the slot's own state lets exactly one exit take the vehicle out, and only then is
+    the slot returned to the bitmap. Each gate thread keeps a cursor just past the last slot it filled and
+    starts its next search there.
+
+    EnterVehicle/ExitVehicle are the ticketed entry and exit: on top of the slot they keep a PlateIndex from
+    registration number to Ticket, so an exit is one hash probe for the plate and one for the slot's zone
+    instead of a scan over every slot. Every entry is recorded in a TicketStore (entry/exit time, slot, type)
+    for fee settlement. A vehicle that entered through EnterVehicle must leave through
+    ExitVehicle; ParkVehcile/UnparkVehicle alone only move slots and leave the index alone.
+
+    Occupancy per floor and per VehicleType is kept in ShardedCounters, so a park adds two relaxed
+    increments on lines owned by the gate's own shard. The lot is observable (CowObservable, lock-free
+    notify) for capacity alerts with hysteresis: NEAR_CAPACITY fires once occupancy reaches the high mark
+    and CAPACITY_OK once it is back down to the low mark, never on ordinary parks and unparks. Gates only
+    sum the counters every check_every_ of their operations (1 for small lots, up to 64 for large ones), so
+    a crossing is seen within a few operations per gate, and an alert runs its observers on the gate thread
+    that saw it.
+
+    With a WriteAheadLog attached, every park and unpark is also queued to the log: a park after its slot is
+    claimed but before the vehicle shows in it, an unpark after the vehicle is out of the slot but before the
+    slot is free again, so the log orders the changes of one slot the way they happened. restore() rebuilds
+    a lot (laid out the same way, floors added in the same order) from WriteAheadLog::recover.
+
+    Pre-booked slots (ReservationBook, see reservation.hpp) come into the lot through the gates: the book's
+    slot i of a size class is slotOfClass(class, i), the i-th slot of that class counting zone by zone in
+    directory order (new floors only add indexes). When a booked window starts the gate holds that slot
+    (holdSlot), which takes it out of the free bitmap without a vehicle, so no other park can take it; the
+    booked vehicle then goes in with ParkReserved, or at the end of a no-show the gate gives the slot back
+    with releaseSlot. A held slot counts as taken in the availability figures. Holds are not logged: after a
+    restart the gates hold the booked slots again from the book.
+*/
+class ParkingLot : public CowObservable<ParkingLot>
+{
+public:
+    static constexpr size_t MAX_ZONES = 4096;
+    static constexpr size_t MAX_GATES = 256;
+
+    // capacity alerts, see setCapacityAlert
+    static constexpr FieldId NEAR_CAPACITY = "near_capacity"_field;
+    static constexpr FieldId CAPACITY_OK = "capacity_ok"_field;
+
+    // what an exit hands back
+    struct Departure
+    {
+        Ticket ticket;
+        VehicleRef vehicle;
+    };
+
+    // per size class occupancy snapshot
+    struct ClassOccupancy
+    {
+        size_t capacity;
+        size_t occupied;
+        size_t borrowed;        // occupied by a smaller vehicle whose own class was full
+    };
+
+private:
+    std::unique_ptr<ZoneRouter> router_;
+    const uint64_t id_;                                 // never reused, unlike this
+
+    static uint64_t next_id()
+    {
+        static std::atomic<uint64_t> ids{0};
+        return ++ids;
+    }
+
+    // written under grow_mtx_ only, read lock-free up to the published counts
+    std::array<Zone*, MAX_ZONES> zones_{};
+    std::atomic<size_t> zone_count_{0};
+    std::array<Position, MAX_GATES> gates_{};
+    std::atomic<size_t> gate_count_{1};                 // gate 0: ground floor entrance
+    std::array<Floor*, MAX_ZONES> floor_dir_{};         // by floor number
+    std::atomic<size_t> floor_count_{0};
+
+    std::mutex grow_mtx_;
+    std::vector<std::unique_ptr<Floor>> floors_;        // owns the zones
+    size_t next_slot_id_{1};
+
+    PlateIndex plates_;
+    TicketStore tickets_;
+
+    std::array<ShardedCounter, VEHICLE_TYPE_COUNT> parked_by_type_;
+    std::atomic<size_t> capacity_{0};
+    double alert_high_fraction_{0}, alert_low_fraction_{0};        // guarded by grow_mtx_, 0 = off
+    std::atomic<size_t> alert_high_{0}, alert_low_{0};              // in slots, alert_high_ 0 = off
+    std::atomic<uint32_t> check_every_{1};
+    std::atomic<bool> near_capacity_{false};
+
+    std::atomic<WriteAheadLog*> log_{nullptr};
+
+    std::span<Zone* const> zones() const
+    {
+        return {zones_.data(), zone_count_.load(std::memory_order_acquire)};
+    }
+
+    // called with grow_mtx_ held whenever capacity or the alert marks change
+    void update_alert_marks()
+    {
+        size_t capacity = capacity_.load(std::memory_order_relaxed);
+        alert_high_.store(static_cast<size_t>(alert_high_fraction_ * capacity), std::memory_order_relaxed);
+        alert_low_.store(static_cast<size_t>(alert_low_fraction_ * capacity), std::memory_order_relaxed);
+        check_every_.store(static_cast<uint32_t>(std::clamp<size_t>(capacity / 8192, 1, 64)),
+                           std::memory_order_relaxed);
+    }
+
+    // one vehicle more (+1) or less (-1) in zone
+    void record(const Zone &zone, VehicleType type, int64_t delta)
+    {
+        floor_dir_[zone.position().floor]->occupied().add(delta);
+        parked_by_type_[static_cast<size_t>(type)].add(delta);
+
+        size_t high = alert_high_.load(std::memory_order_relaxed);
+        if(high == 0) return;
+
+        // occupancy only rises on a park and falls on an unpark: count them apart, so a gate that alternates
+        // the two cannot end up always checking right after the same one
+        thread_local uint32_t parks = 0, unparks = 0;
+        uint32_t &ops = delta > 0 ? parks : unparks;
+        if(++ops < check_every_.load(std::memory_order_relaxed)) return;
+        ops = 0;
+
+        // hysteresis: only the gate that flips the state notifies
+        bool near = near_capacity_.load(std::memory_order_relaxed);
+        if(delta > 0 && !near && getOccupiedSlots() >= high) {
+            if(near_capacity_.compare_exchange_strong(near, true)) notify(*this, NEAR_CAPACITY);
+        }
+        else if(delta < 0 && near && getOccupiedSlots() <= alert_low_.load(std::memory_order_relaxed)) {
+            if(near_capacity_.compare_exchange_strong(near, false)) notify(*this, CAPACITY_OK);
+        }
+    }
+
+    // zone holding slotID, nullptr if no zone does
+    Zone* zone_of(size_t slotID) const
+    {
+        auto all = zones();
+        auto it = std::upper_bound(all.begin(), all.end(), slotID,
+                                   [](size_t id, const Zone *zone) { return id < zone->first_id(); });
+        if(it == all.begin()) return nullptr;
+        Zone *zone = *--it;
+        if(slotID - zone->first_id() >= zone->slot_count()) return nullptr;
+        return zone;
+    }
+
+    // a ticketed park issues the ticket as soon as the slot is claimed, so its PARK record carries it;
+    // the ticket id is 0 otherwise
+    std::optional<Ticket> park(VehicleRef vehicle, size_t gate, bool ticketed)
+    {
+        if(!vehicle) return std::nullopt;
+        if(gate >= gate_count_.load(std::memory_order_acquire)) gate = 0;
+
+        const SlotSize own = slot_size_for(vehicle.type());
+        auto all = zones();
+
+        // a cacheable order is only recomputed when this thread changes lot, gate or class, or a floor is added
+        struct RouteCache
+        {
+            uint64_t lot{0};
+            size_t gate{0};
+            size_t zones{0};
+            SlotSize size{SlotSize::Small};
+            std::vector<Zone*> order;
+        };
+        thread_local RouteCache cache;
+
+        // the zones are tried in order[start], order[start + 1], ... wrapping around
+        std::span<Zone* const> order = all;
+        size_t start = 0;
+        if(router_->rotates()) start = router_->first(all, own, gates_[gate]);
+        else {
+            if(!router_->cacheable() || cache.lot != id_ || cache.gate != gate || cache.zones != all.size() ||
+               cache.size != own) {
+                router_->route(all, own, gates_[gate], cache.order);
+                cache.lot = id_;
+                cache.gate = gate;
+                cache.zones = all.size();
+                cache.size = own;
+            }
+            order = cache.order;
+        }
+
+        size_t &hint = cursor();
+        WriteAheadLog *log = log_.load(std::memory_order_acquire);
+        for(size_t c = static_cast<size_t>(own); c < SLOT_SIZE_COUNT; ++c) {
+            for(size_t i = 0, at = start; i < order.size(); ++i, at = at + 1 == order.size() ? 0 : at + 1) {
+                Zone *zone = order[at];
+                uint64_t ticket = 0;
+                auto slot = zone->park(vehicle, static_cast<SlotSize>(c), hint, [&](size_t id) {
+                    uint32_t entry = 0;
+                    if(ticketed) ticket = tickets_.issue(id, vehicle.type(), entry = tickets_.now());
+                    if(log) {
+                        log->append(WalRecord::park(id, vehicle.type(), vehicle->getRegNo(), ticket,
+                                                    tickets_.unix_time(entry)));
+                    }
+                });
+                if(!slot) continue;
+                hint = *slot + 1;
+                record(*zone, vehicle.type(), +1);
+                return Ticket{ticket, *slot};
+            }
+        }
+        return std::nullopt;
+    }
+
+    // per gate thread search start, new threads are spread evenly over the pools
+    static size_t& cursor()
+    {
+        static std::atomic<size_t> threads{0};
+        thread_local size_t mine = threads.fetch_add(1, std::memory_order_relaxed) * 0x9E3779B97F4A7C15ull >> 16;
+        return mine;
+    }
+
+public:
+    explicit ParkingLot(std::unique_ptr<ZoneRouter> router = std::make_unique<NearestToGateRouter>())
+        : router_(std::move(router)), id_(next_id())
+    {
+    }
+
+    ParkingLot(ParkingLot const&) = delete;
+    ParkingLot& operator=(ParkingLot const&) = delete;
+
+    // appends a floor, returns its number; safe while other threads park and unpark
+    uint32_t addFloor(const std::vector<ZoneConfig> &zones)
+    {
+        std::scoped_lock<std::mutex> lock{grow_mtx_};
+        size_t count = zone_count_.load(std::memory_order_relaxed);
+        if(count + zones.size() > MAX_ZONES || floors_.size() == MAX_ZONES) {
+            throw std::length_error("ParkingLot: too many zones");
+        }
+
+        auto number = static_cast<uint32_t>(floors_.size());
+        auto floor = std::make_unique<Floor>(number, zones, next_slot_id_);
+        next_slot_id_ += floor->slot_count();
+        for(auto &zone : floor->zones()) {
+            if(zone->slot_count() != 0) zones_[count++] = zone.get();
+        }
+        floor_dir_[number] = floor.get();
+        capacity_.fetch_add(floor->slot_count(), std::memory_order_relaxed);
+        floors_.push_back(std::move(floor));
+        update_alert_marks();
+        floor_count_.store(number + 1, std::memory_order_release);
+        zone_count_.store(count, std::memory_order_release);
+        return number;
+    }
+
+    // registers an entry gate, returns the id to pass to ParkVehcile
+    size_t addGate(Position position)
+    {
+        std::scoped_lock<std::mutex> lock{grow_mtx_};
+        size_t count = gate_count_.load(std::memory_order_relaxed);
+        if(count == MAX_GATES) throw std::length_error("ParkingLot: too many gates");
+        gates_[count] = position;
+        gate_count_.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+    // returns the slot ID the vehicle was parked in, nullopt if no slot of its size or larger is free
+    std::optional<size_t> ParkVehcile(VehicleRef vehicle, size_t gate = 0)
+    {
+        auto parked = park(vehicle, gate, false);
+        if(!parked) return std::nullopt;
+        return parked->slot;
+    }
+
+    // frees the slot and hands back the vehicle that was parked there (empty ref if it was empty)
+    VehicleRef UnparkVehicle(size_t slotID)
+    {
+        Zone *zone = zone_of(slotID);
+        if(zone == nullptr) return VehicleRef{};
+        VehicleRef vehicle = zone->unpark(slotID, [&](VehicleRef) {
+            if(auto *log = log_.load(std::memory_order_acquire)) log->append(WalRecord::unpark(slotID));
+        });
+        if(vehicle) record(*zone, vehicle.type(), -1);
+        return vehicle;
+    }
+
+    // starts (or with nullptr stops) logging every park and unpark; the log must outlive its use
+    void attachLog(WriteAheadLog *log)
+    {
+        log_.store(log, std::memory_order_release);
+    }
+
+    // puts recovered vehicles back into their slots, with new VehicleFactory vehicles, without logging them.
+    // Ticketed ones get their ticket back with its entry time; into a lot that has not issued a ticket yet
+    // also under its old id (and later tickets continue after it), otherwise under a new one. Returns how
+    // many were restored (a slot outside the lot is skipped)
+    size_t restore(const LotState &state)
+    {
+        size_t restored = 0;
+        std::vector<const LotState::Parked*> ticketed;
+        for(auto &parked : state.vehicles) {
+            auto vehicle = VehicleFactory::createVehicle(parked.type, parked.plate.view());
+            Zone *zone = zone_of(parked.slot);
+            if(!vehicle || zone == nullptr || !zone->place(parked.slot, vehicle)) {
+                VehicleFactory::destroyVehicle(vehicle);
+                continue;
+            }
+            record(*zone, parked.type, +1);
+            ++restored;
+            if(parked.ticketed) ticketed.push_back(&parked);
+        }
+
+        // reissue() wants increasing ids, and the store's epoch must not be after the earliest entry
+        std::sort(ticketed.begin(), ticketed.end(), [](auto *a, auto *b) { return a->ticket < b->ticket; });
+        const bool keep_ids = tickets_.size() == 0;
+        if(keep_ids && !ticketed.empty()) {
+            auto earliest = std::min_element(ticketed.begin(), ticketed.end(),
+                                             [](auto *a, auto *b) { return a->entry < b->entry; });
+            tickets_.rebase((*earliest)->entry);
+        }
+        for(auto *parked : ticketed) {
+            auto key = PlateKey::of(parked->plate.view());
+            if(!key) continue;
+            uint32_t entry = tickets_.store_time(parked->entry);
+            uint64_t id = keep_ids && tickets_.reissue(parked->ticket, parked->slot, parked->type, entry)
+                              ? parked->ticket
+                              : tickets_.issue(parked->slot, parked->type, entry);
+            Ticket ticket{id, parked->slot};
+            if(!plates_.insert(*key, ticket)) tickets_.close(ticket.id, TicketStore::VOID);
+        }
+        return restored;
+    }
+
+    // slot ID of the index-th slot of size class size, counting zone by zone; nullopt past the last one
+    std::optional<size_t> slotOfClass(SlotSize size, size_t index) const
+    {
+        for(Zone *zone : zones()) {
+            const SlotPool &pool = zone->pool(size);
+            if(index < pool.size()) return pool.slot_id(index);
+            index -= pool.size();
+        }
+        return std::nullopt;
+    }
+
+    // a booked window starts: keeps the slot free for ParkReserved; false if it is occupied (or held)
+    bool holdSlot(size_t slotID)
+    {
+        Zone *zone = zone_of(slotID);
+        return zone != nullptr && zone->hold(slotID);
+    }
+
+    // the booked vehicle arrives: parks it in the slot this gate holds for it; false for an empty vehicle
+    // ref or a slot that is not the lot's
+    bool ParkReserved(VehicleRef vehicle, size_t slotID)
+    {
+        Zone *zone = zone_of(slotID);
+        if(!vehicle || zone == nullptr) return false;
+        if(auto *log = log_.load(std::memory_order_acquire)) {
+            log->append(WalRecord::park(slotID, vehicle.type(), vehicle->getRegNo(), 0, 0));
+        }
+        zone->fill(slotID, vehicle);
+        record(*zone, vehicle.type(), +1);
+        return true;
+    }
+
+    // no-show: gives a slot held by holdSlot (and not filled) back to parking
+    void releaseSlot(size_t slotID)
+    {
+        if(Zone *zone = zone_of(slotID)) zone->unhold(slotID);
+    }
+
+    // NEAR_CAPACITY once the lot is high (fraction of capacity) full, CAPACITY_OK once back down to low
+    void setCapacityAlert(double high, double low)
+    {
+        if(!(0 < low && low < high && high <= 1)) throw std::invalid_argument("ParkingLot: need 0 < low < high <= 1");
+        std::scoped_lock<std::mutex> lock{grow_mtx_};
+        alert_high_fraction_ = high;
+        alert_low_fraction_ = low;
+        update_alert_marks();
+    }
+
+    void disableCapacityAlert()
+    {
+        std::scoped_lock<std::mutex> lock{grow_mtx_};
+        alert_high_fraction_ = alert_low_fraction_ = 0;
+        update_alert_marks();
+        near_capacity_.store(false, std::memory_order_relaxed);
+    }
+
+    bool isNearCapacity() const
+    {
+        return near_capacity_.load(std::memory_order_relaxed);
+    }
+
+    // occupancy from the sharded counters: cheap, exact once concurrent parks/unparks have returned
+    size_t getOccupiedSlots() const
+    {
+        int64_t occupied = 0;
+        for(auto &counter : parked_by_type_) occupied += counter.value();
+        return static_cast<size_t>(std::max<int64_t>(occupied, 0));
+    }
+
+    size_t getOccupiedSlots(VehicleType type) const
+    {
+        return static_cast<size_t>(std::max<int64_t>(parked_by_type_[static_cast<size_t>(type)].value(), 0));
+    }
+
+    // 0 for a floor that does not exist
+    size_t getFloorOccupancy(uint32_t floor) const
+    {
+        if(floor >= floor_count_.load(std::memory_order_acquire)) return 0;
+        return static_cast<size_t>(std::max<int64_t>(floor_dir_[floor]->occupied().value(), 0));
+    }
+
+    // parks the vehicle and files its plate; nullopt if no slot fits, the plate is invalid or already parked
+    std::optional<Ticket> EnterVehicle(VehicleRef vehicle, size_t gate = 0)
+    {
+        if(!vehicle) return std::nullopt;
+        auto key = PlateKey::of(vehicle->getRegNo());
+        if(!key) return std::nullopt;
+
+        auto ticket = park(vehicle, gate, true);
+        if(!ticket) return std::nullopt;
+        if(!plates_.insert(*key, *ticket)) {
+            tickets_.close(ticket->id, TicketStore::VOID);
+            UnparkVehicle(ticket->slot);        // the same plate got in first
+            return std::nullopt;
+        }
+        return ticket;
+    }
+
+    // where the vehicle with this registration number is parked, nullopt if it is not; lock-free
+    std::optional<Ticket> findVehicle(std::string_view regNo) const
+    {
+        auto key = PlateKey::of(regNo);
+        if(!key) return std::nullopt;
+        return plates_.find(*key);
+    }
+
+    // unparks the vehicle with this registration number; nullopt if it is not parked (or another exit won)
+    std::optional<Departure> ExitVehicle(std::string_view regNo)
+    {
+        auto key = PlateKey::of(regNo);
+        if(!key) return std::nullopt;
+        auto ticket = plates_.take(*key);
+        if(!ticket) return std::nullopt;
+        tickets_.close(ticket->id, tickets_.now());
+        return Departure{*ticket, UnparkVehicle(ticket->slot)};
+    }
+
+    // every ticket issued by EnterVehicle, for fee settlement
+    const TicketStore& tickets() const
+    {
+        return tickets_;
+    }
+
+    size_t getAvailableSlots() const
+    {
+        size_t available = 0;
+        for(Zone *zone : zones()) {
+            for(size_t c = 0; c < SLOT_SIZE_COUNT; ++c) available += zone->available(static_cast<SlotSize>(c));
+        }
+        return available;
+    }
+
+    size_t getAvailableSlots(SlotSize size) const
+    {
+        size_t available = 0;
+        for(Zone *zone : zones()) available += zone->available(size);
+        return available;
+    }
+
+    ClassOccupancy getOccupancy(SlotSize size) const
+    {
+        ClassOccupancy total{0, 0, 0};
+        for(Zone *zone : zones()) {
+            auto &pool = zone->pool(size);
+            total.capacity += pool.size();
+            total.occupied += pool.occupied();
+            total.borrowed += pool.borrowed();
+        }
+        return total;
+    }
+
+    // parked vehicles per VehicleType (indexed by the enum), scanned from the slot arrays
+    std::array<size_t, VEHICLE_TYPE_COUNT> getOccupancyByType() const
+    {
+        std::array<size_t, VEHICLE_TYPE_COUNT> counts{};
+        for(Zone *zone : zones()) zone->count_by_type(counts);
+        return counts;
+    }
+
+    size_t getCapacity() const
+    {
+        size_t capacity = 0;
+        for(Zone *zone : zones()) capacity += zone->slot_count();
+        return capacity;
+    }
+
+    size_t getZoneCount() const
+    {
+        return zones().size();
+    }
+};
+
+// The process wide lot: one ground floor of two zones, more floors can be added at runtime
+class SingletonParkingLot : public ParkingLot
+{
+    SingletonParkingLot()
+    {
+        ZoneConfig west, east;
+        for(size_t c = 0; c < SLOT_SIZE_COUNT; ++c) {
+            west.slots[c] = SLOTS_PER_SIZE[c] / 2;
+            east.slots[c] = SLOTS_PER_SIZE[c] - west.slots[c];
+        }
+        east.offset = 50;
+        addFloor({west, east});
+    }
+
+public:
+    static SingletonParkingLot& getInstance()
+    {
+        // Thread safe Meyer's singleton
+        static SingletonParkingLot instance;
+        return instance;
+    }
+};
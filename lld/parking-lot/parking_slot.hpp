@@ -1,18 +1,35 @@
 #pragma once
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include "vehicle.hpp"
 
-// Parking Slot
+// Parking Slot, one object per slot
+/*
+    The lot itself keeps slots as parallel arrays (see SlotPool); this object form is the baseline that
+    bench_allocator and bench_slot_layout compare against.
+
+    The slot is handed out exclusively by the lot's FreeBitmap, so OccupySlot never races with another park.
+    The state word is what makes unparking safe: FreeSlot only takes the vehicle out after winning the
+    occupied -> leaving compare-and-swap, so two exits presenting the same slot cannot both get it.
+*/
 struct ParkingSlot
 {
 private:
+    enum State : uint8_t { free, occupied, leaving };
+
     size_t slotID_;
     std::shared_ptr<Vehicle> vehicle_;
-    static size_t counter_;
+    std::atomic<uint8_t> state_{free};
+    static inline std::atomic<size_t> counter_{0};
 
 public:
     ParkingSlot() : slotID_(++counter_), vehicle_(nullptr) {}
 
+    ParkingSlot(const ParkingSlot&) = delete;
+    ParkingSlot& operator=(const ParkingSlot&) = delete;
+
     size_t getSlotID() const
     {
         return slotID_;
@@ -20,13 +37,29 @@ public:
 
     bool isOccupied() const
     {
-        return (vehicle_ != nullptr);
+        return state_.load(std::memory_order_acquire) == occupied;
     }
 
     void OccupySlot(std::shared_ptr<Vehicle> vehicle)
     {
         if(vehicle == nullptr)
             return;
-        vehicle_ = vehicle;
+        vehicle_ = std::move(vehicle);
+        state_.store(occupied, std::memory_order_release);
+    }
+
+    // nullptr if the slot was not occupied (or another thread is already freeing it)
+    std::shared_ptr<Vehicle> FreeSlot()
+    {
+        uint8_t expected = occupied;
+        if(!state_.compare_exchange_strong(expected, leaving, std::memory_order_acquire)) return nullptr;
+        auto vehicle = std::move(vehicle_);
+        state_.store(free, std::memory_order_release);
+        return vehicle;
+    }
+
+    const std::shared_ptr<Vehicle>& getVehicle() const
+    {
+        return vehicle_;
     }
 };
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "vehicle.hpp"
+
+// Issued at entry: which slot the vehicle got, under which ticket number
+struct Ticket
+{
+    uint64_t id{0};
+    size_t slot{0};
+};
+
+// A PlateNumber packed into two words, hashed and compared without touching a string
+struct PlateKey
+{
+    uint64_t lo{0};
+    uint64_t hi{0};
+
+    static_assert(sizeof(PlateNumber) == 2 * sizeof(uint64_t) && std::is_trivially_copyable_v<PlateNumber>);
+
+    // nullopt for an empty plate (the all-zero key marks an empty bucket) or one longer than MAX_LENGTH
+    static std::optional<PlateKey> of(std::string_view regNo)
+    {
+        if(regNo.empty() || regNo.size() > PlateNumber::MAX_LENGTH) return std::nullopt;
+        PlateNumber plate{regNo};
+        PlateKey key;
+        std::memcpy(&key.lo, reinterpret_cast<const char*>(&plate), sizeof(uint64_t));
+        std::memcpy(&key.hi, reinterpret_cast<const char*>(&plate) + sizeof(uint64_t), sizeof(uint64_t));
+        return key;
+    }
+
+    bool empty() const { return lo == 0 && hi == 0; }
+    bool operator==(const PlateKey &other) const { return lo == other.lo && hi == other.hi; }
+
+    uint64_t hash() const
+    {
+        uint64_t h = (lo ^ (hi * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull;
+        return h ^ (h >> 31);
+    }
+};
+
+// Concurrent registration number -> Ticket index
+/*
+    SHARDS independent open addressing tables with linear probing; the top bits of the key's hash pick the
+    shard, the low bits the home bucket. A bucket is the packed plate plus the ticket, 32 bytes, so a lookup
+    is one hash and usually one cache line.
+
+    Lookups take no lock. Each shard has a sequence counter that writers make odd while they change the
+    table; a reader probes and retries if the counter moved, so it never acts on a half-written bucket.
+    Bucket words are stored with release and loaded with acquire (plain moves on x86), which orders them
+    against the counter without fences.
+    Inserts and erases of one shard are serialised by its mutex, which makes "is this plate already parked"
+    and "take this plate out" atomic. Erase shifts the following run of the probe chain back (no tombstones),
+    so chains stay short under constant churn.
+
+    A shard doubles when it gets half full. The old table is kept until the index is destroyed, since a
+    reader may still be probing it; at most as much memory again is held that way.
+*/
+class PlateIndex
+{
+public:
+    static constexpr size_t SHARDS = 64;
+
+private:
+    struct Bucket
+    {
+        std::atomic<uint64_t> lo{0}, hi{0};             // PlateKey, 0/0 = empty
+        std::atomic<uint64_t> ticket{0};
+        std::atomic<uint64_t> slot{0};
+    };
+
+    struct Table
+    {
+        size_t mask;
+        std::unique_ptr<Bucket[]> buckets;
+
+        explicit Table(size_t size) : mask(size - 1), buckets(new Bucket[size]) {}
+    };
+
+    struct alignas(64) Shard
+    {
+        std::atomic<uint64_t> seq{0};                   // odd while a writer is changing the table
+        std::atomic<Table*> table{nullptr};
+        mutable std::mutex mtx;
+        size_t count{0};                                // guarded by mtx
+        std::vector<std::unique_ptr<Table>> tables;     // current one last, older ones kept for readers
+    };
+
+    std::array<Shard, SHARDS> shards_;
+
+    static size_t shard_of(uint64_t hash) { return hash >> 58; }
+
+    static PlateKey key_at(const Bucket &b)
+    {
+        return PlateKey{b.lo.load(std::memory_order_acquire), b.hi.load(std::memory_order_acquire)};
+    }
+
+    static void copy(Bucket &to, const Bucket &from)
+    {
+        to.ticket.store(from.ticket.load(std::memory_order_acquire), std::memory_order_release);
+        to.slot.store(from.slot.load(std::memory_order_acquire), std::memory_order_release);
+        to.lo.store(from.lo.load(std::memory_order_acquire), std::memory_order_release);
+        to.hi.store(from.hi.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    static void clear(Bucket &b)
+    {
+        b.lo.store(0, std::memory_order_release);
+        b.hi.store(0, std::memory_order_release);
+    }
+
+    // bucket holding key or the empty bucket ending its chain; caller holds the shard's mutex
+    static Bucket& probe(const Table &table, const PlateKey &key)
+    {
+        for(size_t i = key.hash() & table.mask;; i = (i + 1) & table.mask) {
+            Bucket &b = table.buckets[i];
+            PlateKey k = key_at(b);
+            if(k.empty() || k == key) return b;
+        }
+    }
+
+    // writers bracket every change with these two, under the shard's mutex
+    static void begin_write(Shard &shard)
+    {
+        shard.seq.store(shard.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    static void end_write(Shard &shard)
+    {
+        shard.seq.store(shard.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // doubles the shard's table; old readers keep probing the old one and retry when seq has moved
+    static void grow(Shard &shard)
+    {
+        const Table &old = *shard.tables.back();
+        auto bigger = std::make_unique<Table>((old.mask + 1) * 2);
+        for(size_t i = 0; i <= old.mask; ++i) {
+            const Bucket &b = old.buckets[i];
+            if(!key_at(b).empty()) copy(probe(*bigger, key_at(b)), b);
+        }
+        shard.table.store(bigger.get(), std::memory_order_release);
+        shard.tables.push_back(std::move(bigger));
+    }
+
+    // removes bucket i and shifts the rest of its run back so no probe chain is broken
+    static void erase_at(const Table &table, size_t i)
+    {
+        for(size_t j = (i + 1) & table.mask;; j = (j + 1) & table.mask) {
+            Bucket &b = table.buckets[j];
+            PlateKey k = key_at(b);
+            if(k.empty()) break;
+            size_t home = k.hash() & table.mask;
+            // b may move to i only if i lies on its chain, i.e. cyclically in [home, j)
+            if(((j - home) & table.mask) >= ((j - i) & table.mask)) {
+                copy(table.buckets[i], b);
+                i = j;
+            }
+        }
+        clear(table.buckets[i]);
+    }
+
+public:
+    // initial capacity, spread over the shards; the index grows past it on its own
+    explicit PlateIndex(size_t capacity = 1024)
+    {
+        size_t per_shard = 16;
+        while(per_shard < 2 * capacity / SHARDS) per_shard *= 2;
+        for(auto &shard : shards_) {
+            shard.tables.push_back(std::make_unique<Table>(per_shard));
+            shard.table.store(shard.tables.back().get(), std::memory_order_relaxed);
+        }
+    }
+
+    PlateIndex(const PlateIndex&) = delete;
+    PlateIndex& operator=(const PlateIndex&) = delete;
+
+    // false if the plate is already in the index
+    bool insert(const PlateKey &key, const Ticket &ticket)
+    {
+        Shard &shard = shards_[shard_of(key.hash())];
+        std::scoped_lock<std::mutex> lock{shard.mtx};
+
+        Table *table = shard.tables.back().get();
+        if(!key_at(probe(*table, key)).empty()) return false;
+
+        begin_write(shard);
+        if(2 * (shard.count + 1) > table->mask + 1) {
+            grow(shard);
+            table = shard.tables.back().get();
+        }
+        Bucket &b = probe(*table, key);
+        b.ticket.store(ticket.id, std::memory_order_release);
+        b.slot.store(ticket.slot, std::memory_order_release);
+        b.lo.store(key.lo, std::memory_order_release);
+        b.hi.store(key.hi, std::memory_order_release);
+        ++shard.count;
+        end_write(shard);
+        return true;
+    }
+
+    // lock-free lookup, nullopt if the plate is not parked
+    std::optional<Ticket> find(const PlateKey &key) const
+    {
+        const Shard &shard = shards_[shard_of(key.hash())];
+        for(;;) {
+            uint64_t seq = shard.seq.load(std::memory_order_acquire);
+            if(seq & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const Table &table = *shard.table.load(std::memory_order_acquire);
+            std::optional<Ticket> found;
+            for(size_t i = key.hash() & table.mask;; i = (i + 1) & table.mask) {
+                const Bucket &b = table.buckets[i];
+                PlateKey k = key_at(b);
+                if(k.empty()) break;
+                if(k == key) {
+                    found = Ticket{b.ticket.load(std::memory_order_acquire), b.slot.load(std::memory_order_acquire)};
+                    break;
+                }
+                // a chain can only be longer than the table while a writer is shifting it, retry then
+                if(((i - (key.hash() & table.mask)) & table.mask) == table.mask) break;
+            }
+
+            if(shard.seq.load(std::memory_order_relaxed) == seq) return found;
+        }
+    }
+
+    // removes the plate and returns its ticket, nullopt if it was not there; exactly one caller gets it
+    std::optional<Ticket> take(const PlateKey &key)
+    {
+        Shard &shard = shards_[shard_of(key.hash())];
+        std::scoped_lock<std::mutex> lock{shard.mtx};
+
+        const Table &table = *shard.tables.back();
+        Bucket &b = probe(table, key);
+        if(key_at(b).empty()) return std::nullopt;
+
+        Ticket ticket{b.ticket.load(std::memory_order_acquire), b.slot.load(std::memory_order_acquire)};
+        begin_write(shard);
+        erase_at(table, static_cast<size_t>(&b - table.buckets.get()));
+        --shard.count;
+        end_write(shard);
+        return ticket;
+    }
+
+    size_t size() const
+    {
+        size_t n = 0;
+        for(auto &shard : shards_) {
+            std::scoped_lock<std::mutex> lock{shard.mtx};
+            n += shard.count;
+        }
+        return n;
+    }
+
+    size_t memory_bytes() const
+    {
+        size_t bytes = sizeof(*this);
+        for(auto &shard : shards_) {
+            std::scoped_lock<std::mutex> lock{shard.mtx};
+            for(auto &table : shard.tables) bytes += sizeof(Table) + (table->mask + 1) * sizeof(Bucket);
+        }
+        return bytes;
+    }
+};
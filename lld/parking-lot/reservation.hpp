@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+#include "vehicle.hpp"
+#include "slot_pool.hpp"
+
+// A booked slot: slot index within its size class (ParkingLot::slotOfClass gives the slot ID), held for
+// buckets first..last (inclusive)
+struct Reservation
+{
+    SlotSize size;
+    uint32_t slot;
+    uint32_t first;
+    uint32_t last;
+};
+
+// Pre-booking calendar of a lot: which slot of each size class is free in which time bucket
+/*
+    Time is cut into buckets of bucket_seconds (15 minutes by default) over a fixed horizon from the book's
+    start; a reservation holds whole buckets, so [t1, t2) is rounded out to the buckets it touches. Every
+    size class keeps one bit per slot and bucket (1 = free), stored word-major: the words of all buckets of
+    64 slots are adjacent, so checking a window of k buckets for 64 slots at once is k consecutive loads.
+
+    A slot is free throughout a window if it is free in every bucket of it. Per bitmap word and bucket b the
+    book keeps the longest run of buckets from b in which one of the word's 64 slots stays free (the number
+    of words ANDed from b before the result is 0), and per group of 64 words the largest of those. A query
+    for k buckets from b reads the group maxima at b, enters a group whose maximum is >= k, picks a word in it
+    whose run is >= k and ANDs that word's k leaves, which then has a bit set: about n / 4096 + 64 + k loads
+    for n slots, where a scan over per-slot interval lists reads every slot, and exact, not a hint.
+
+    Bits are claimed lock-free, bucket by bucket with fetch_and; a booking that finds one of its buckets
+    taken by a concurrent booking hands back the ones it took and searches again, so two bookings never
+    share a slot-bucket. After every change the runs it can have touched (its buckets and the free buckets
+    of that slot before them) are recomputed from the bitmap under the group's mutex; queries read them
+    without locking, so one racing with a booking may pass over a slot that is changing, or try a word that
+    has just filled up and move on.
+
+    A book covers buckets 0 .. buckets - 1 and does not roll over; start the next one before the horizon ends.
+
+    The book only plans; parking is the lot's. A book for a ParkingLot is made with the lot's slots per size
+    class (getOccupancy(c).capacity), and Reservation::slot is an index within its class, not a slot ID:
+    ParkingLot::slotOfClass(r.size, r.slot) is the slot. The gates keep the booked slot free during the
+    window: holdSlot when it starts, ParkReserved when the vehicle arrives, releaseSlot at the end of a
+    no-show (see ParkingLot). A slot still occupied when its window starts cannot be held until it is left.
+*/
+class ReservationBook
+{
+    struct SizeClass
+    {
+        size_t slots{0};
+        size_t words{0};
+        size_t groups{0};
+        std::unique_ptr<std::atomic<uint64_t>[]> leaves;            // [word * buckets + bucket]
+        std::unique_ptr<std::atomic<uint16_t>[]> word_run;          // [(group * buckets + bucket) * 64 + word % 64]
+        std::unique_ptr<std::atomic<uint16_t>[]> group_run;         // [bucket * groups + group]
+        std::unique_ptr<std::mutex[]> group_mtx;
+    };
+
+    uint32_t bucket_seconds_;
+    size_t buckets_;
+    std::array<SizeClass, SLOT_SIZE_COUNT> classes_;
+
+    // first set bit of word at or after position start, wrapping around; word must not be 0
+    static size_t pick(uint64_t word, size_t start)
+    {
+        return (std::countr_zero(std::rotr(word, static_cast<int>(start))) + start) % 64;
+    }
+
+    std::atomic<uint64_t>& leaf(const SizeClass &c, size_t word, size_t bucket) const
+    {
+        return c.leaves[word * buckets_ + bucket];
+    }
+
+    std::atomic<uint16_t>& word_run(const SizeClass &c, size_t word, size_t bucket) const
+    {
+        return c.word_run[(word / 64 * buckets_ + bucket) * 64 + word % 64];
+    }
+
+    // longest run of buckets from bucket in which one slot of the word stays free
+    uint16_t run_from(const SizeClass &c, size_t word, size_t bucket) const
+    {
+        uint64_t free = ~uint64_t{0};
+        size_t b = bucket;
+        for(; b < buckets_; ++b) {
+            free &= leaf(c, word, b).load(std::memory_order_relaxed);
+            if(free == 0) break;
+        }
+        return static_cast<uint16_t>(b - bucket);
+    }
+
+    // slot changed in first..last: recompute the runs that can start at one of those buckets or reach them
+    void update(const SizeClass &c, size_t slot, size_t first, size_t last) const
+    {
+        const size_t word = slot / 64, group = word / 64;
+        const uint64_t bit = uint64_t{1} << (slot % 64);
+        std::scoped_lock<std::mutex> lock{c.group_mtx[group]};
+
+        // the slot's free buckets right before first lead into the window
+        while(first > 0 && (leaf(c, word, first - 1).load() & bit)) --first;
+        for(size_t b = first; b <= last; ++b) {
+            uint16_t run = run_from(c, word, b);
+            uint16_t old = word_run(c, word, b).exchange(run, std::memory_order_relaxed);
+            auto &group_run = c.group_run[b * c.groups + group];
+            uint16_t best = group_run.load(std::memory_order_relaxed);
+            if(run > best) group_run.store(run, std::memory_order_relaxed);
+            if(run >= old || old < best) continue;
+
+            // this word held the group's longest run and lost it
+            best = 0;
+            for(size_t w = group * 64; w < std::min(c.words, group * 64 + 64); ++w) {
+                best = std::max(best, word_run(c, w, b).load(std::memory_order_relaxed));
+            }
+            group_run.store(best, std::memory_order_relaxed);
+        }
+    }
+
+    void release(const SizeClass &c, size_t slot, size_t first, size_t last) const
+    {
+        uint64_t bit = uint64_t{1} << (slot % 64);
+        for(size_t b = first; b <= last; ++b) leaf(c, slot / 64, b).fetch_or(bit);
+    }
+
+    // takes slot in every bucket of first..last, or in none
+    bool claim(const SizeClass &c, size_t slot, size_t first, size_t last) const
+    {
+        uint64_t bit = uint64_t{1} << (slot % 64);
+        for(size_t b = first; b <= last; ++b) {
+            if(leaf(c, slot / 64, b).fetch_and(~bit) & bit) continue;
+            if(b == first) return false;
+            // a query may have recomputed runs from the half claimed bits meanwhile
+            release(c, slot, first, b - 1);
+            update(c, slot, first, b - 1);
+            return false;
+        }
+        update(c, slot, first, last);
+        return true;
+    }
+
+    // a slot of this class free in every bucket of first..last, searching from hint
+    std::optional<size_t> search(const SizeClass &c, size_t first, size_t last, size_t hint) const
+    {
+        if(c.slots == 0) return std::nullopt;
+        hint %= c.slots;
+        const size_t k = last - first + 1;
+        for(size_t i = 0; i < c.groups; ++i) {
+            size_t g = (hint / 4096 + i) % c.groups;
+            if(c.group_run[first * c.groups + g].load(std::memory_order_relaxed) < k) continue;
+
+            size_t words = std::min<size_t>(c.words - g * 64, 64);
+            for(size_t j = 0; j < words; ++j) {
+                size_t w = g * 64 + (hint / 64 + j) % words;
+                if(word_run(c, w, first).load(std::memory_order_relaxed) < k) continue;
+                uint64_t bits = ~uint64_t{0};
+                for(size_t b = first; b <= last && bits; ++b) bits &= leaf(c, w, b).load();
+                if(bits) return w * 64 + pick(bits, hint % 64);
+            }
+        }
+        return std::nullopt;
+    }
+
+    // bucket range of [from, to), false if it is empty or goes past the horizon
+    bool window(uint32_t from, uint32_t to, size_t &first, size_t &last) const
+    {
+        if(to <= from) return false;
+        first = from / bucket_seconds_;
+        last = (to - 1) / bucket_seconds_;
+        return last < buckets_;
+    }
+
+public:
+    static constexpr uint32_t QUARTER_HOUR = 15 * 60;
+    static constexpr size_t MAX_BUCKETS = UINT16_MAX;
+
+    // slots[c] slots of size class c, all free; throws std::invalid_argument on an empty or too long calendar
+    explicit ReservationBook(const std::array<size_t, SLOT_SIZE_COUNT> &slots,
+                             uint32_t bucket_seconds = QUARTER_HOUR, size_t buckets = 7 * 24 * 4)
+        : bucket_seconds_(bucket_seconds), buckets_(buckets)
+    {
+        if(bucket_seconds == 0 || buckets == 0 || buckets > MAX_BUCKETS) {
+            throw std::invalid_argument("ReservationBook: calendar must have 1 to 65535 buckets");
+        }
+        for(size_t i = 0; i < SLOT_SIZE_COUNT; ++i) {
+            SizeClass &c = classes_[i];
+            c.slots = slots[i];
+            c.words = (c.slots + 63) / 64;
+            c.groups = (c.words + 63) / 64;
+            c.leaves.reset(new std::atomic<uint64_t>[c.words * buckets]);
+            c.word_run.reset(new std::atomic<uint16_t>[c.groups * 64 * buckets]);
+            c.group_run.reset(new std::atomic<uint16_t>[c.groups * buckets]);
+            c.group_mtx.reset(new std::mutex[c.groups]);
+
+            // all free: every run lasts to the end of the calendar
+            for(size_t w = 0; w < c.groups * 64; ++w) {
+                uint64_t bits = (w + 1) * 64 <= c.slots ? ~uint64_t{0} :
+                                w * 64 < c.slots ? (uint64_t{1} << (c.slots % 64)) - 1 : 0;
+                for(size_t b = 0; b < buckets; ++b) {
+                    if(w < c.words) leaf(c, w, b).store(bits, std::memory_order_relaxed);
+                    word_run(c, w, b).store(static_cast<uint16_t>(bits ? buckets - b : 0), std::memory_order_relaxed);
+                }
+            }
+            for(size_t b = 0; b < buckets; ++b) {
+                for(size_t g = 0; g < c.groups; ++g) {
+                    c.group_run[b * c.groups + g].store(static_cast<uint16_t>(buckets - b), std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    ReservationBook(const ReservationBook&) = delete;
+    ReservationBook& operator=(const ReservationBook&) = delete;
+
+    // a slot free throughout [from, to) (seconds since the book's start) for this vehicle, in its own size
+    // class first, then larger ones as parking does; nullopt if none is or the window is past the horizon
+    std::optional<Reservation> find(VehicleType type, uint32_t from, uint32_t to, size_t hint = 0) const
+    {
+        size_t first, last;
+        if(!window(from, to, first, last)) return std::nullopt;
+        for(size_t c = static_cast<size_t>(slot_size_for(type)); c < SLOT_SIZE_COUNT; ++c) {
+            if(auto slot = search(classes_[c], first, last, hint)) {
+                return Reservation{static_cast<SlotSize>(c), static_cast<uint32_t>(*slot),
+                                   static_cast<uint32_t>(first), static_cast<uint32_t>(last)};
+            }
+        }
+        return std::nullopt;
+    }
+
+    // books such a slot; hint spreads concurrent bookers (e.g. one per booking thread) over different groups
+    std::optional<Reservation> book(VehicleType type, uint32_t from, uint32_t to, size_t hint = 0)
+    {
+        size_t first, last;
+        if(!window(from, to, first, last)) return std::nullopt;
+        for(size_t c = static_cast<size_t>(slot_size_for(type)); c < SLOT_SIZE_COUNT; ++c) {
+            // a failed claim lost a bucket to a concurrent booking, the next search no longer sees that slot
+            while(auto slot = search(classes_[c], first, last, hint)) {
+                if(claim(classes_[c], *slot, first, last)) {
+                    return Reservation{static_cast<SlotSize>(c), static_cast<uint32_t>(*slot),
+                                       static_cast<uint32_t>(first), static_cast<uint32_t>(last)};
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    // books this very slot, false if it is taken in any bucket of the window
+    bool book(const Reservation &r)
+    {
+        const SizeClass &c = classes_[static_cast<size_t>(r.size)];
+        if(r.slot >= c.slots || r.first > r.last || r.last >= buckets_) return false;
+        return claim(c, r.slot, r.first, r.last);
+    }
+
+    // gives a booked window back; r must come from a successful booking and be cancelled once
+    void cancel(const Reservation &r)
+    {
+        const SizeClass &c = classes_[static_cast<size_t>(r.size)];
+        release(c, r.slot, r.first, r.last);
+        update(c, r.slot, r.first, r.last);
+    }
+
+    bool is_free(SlotSize size, size_t slot, size_t bucket) const
+    {
+        const SizeClass &c = classes_[static_cast<size_t>(size)];
+        return (leaf(c, slot / 64, bucket).load() >> (slot % 64)) & 1;
+    }
+
+    size_t memory_bytes() const
+    {
+        size_t bytes = sizeof(*this);
+        for(auto &c : classes_) {
+            bytes += c.words * buckets_ * sizeof(uint64_t) + (c.groups * 65 * buckets_) * sizeof(uint16_t) +
+                     c.groups * sizeof(std::mutex);
+        }
+        return bytes;
+    }
+
+    uint32_t bucket_seconds() const { return bucket_seconds_; }
+    size_t buckets() const { return buckets_; }
+    uint32_t horizon() const { return static_cast<uint32_t>(bucket_seconds_ * buckets_); }
+};
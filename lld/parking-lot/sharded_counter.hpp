@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Counter split over cache-line padded shards, one per gate thread (modulo SHARDS)
+/*
+    add() is a relaxed fetch_add on the calling thread's own line, so gates updating the same counter never
+    bounce a cache line between cores; value() pays instead, summing every shard. Threads are spread over the
+    shards round robin as they first touch any counter (a portable stand-in for per-core slots: gate threads
+    are long lived, so they behave the same). value() is exact once the updates it should see have happened,
+    and never off by more than the updates still in flight.
+*/
+class ShardedCounter
+{
+public:
+    static constexpr size_t SHARDS = 16;
+
+private:
+    struct alignas(64) Shard
+    {
+        std::atomic<int64_t> value{0};
+    };
+
+    std::array<Shard, SHARDS> shards_;
+
+public:
+    ShardedCounter() = default;
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    // this thread's shard, shared by every counter
+    static size_t shard()
+    {
+        static std::atomic<size_t> threads{0};
+        thread_local size_t mine = threads.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+        return mine;
+    }
+
+    void add(int64_t delta)
+    {
+        shards_[shard()].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    int64_t value() const
+    {
+        int64_t sum = 0;
+        for(auto &s : shards_) sum += s.value.load(std::memory_order_relaxed);
+        return sum;
+    }
+};
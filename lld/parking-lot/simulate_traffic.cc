@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "parking_lot.hpp"
+
+/*
+    Discrete-event traffic simulator and load test for SingletonParkingLot. Every gate thread owns an event
+    queue: arrivals from a seeded arrival process and the departures it scheduled when a vehicle got in.
+    An arrival creates a vehicle through VehicleFactory and enters it with EnterVehicle (a full lot turns it
+    away); a departure leaves with ExitVehicle by plate; after every arrival the gate also looks up `lookups`
+    random plates it has parked (findVehicle), as a payment kiosk would. Only the lot calls are timed.
+
+    Simulated time is shared: the gates run one simulated minute at a time and meet at a barrier, so the
+    lot's occupancy follows the modelled day, while the lot is driven as fast as the gates can go.
+    profiles  poisson -> constant arrival rate
+              rush    -> a night floor with morning (08:30) and evening (17:30) peaks, same daily total
+    The rate is set so that the lot would be `load` full on average (Little's law with the mean stay; the
+    default 0.5 makes the rush hour peaks just reach capacity);
+    vehicles are 20% motorcycles, 60% cars, 15% trucks, 5% buses, like the slot mix, and stay an exponential
+    time of mean 2h (at least 5 minutes).
+
+    Each gate's arrivals, vehicle types, plates, stays and lookups depend only on the seed and the gate
+    number. Which gate gets the last free slot of a minute depends on thread timing, so turned_away (and
+    what follows from it) can differ slightly between runs of the same seed.
+
+    Output: one summary line, then latency percentiles per operation from log-linear histograms (16 buckets
+    per power of two, values are bucket upper bounds, ~6% resolution).
+
+    build: g++ -std=c++20 -O2 -pthread simulate_traffic.cc -o simulate_traffic
+    run:   ./simulate_traffic [gates] [hours] [poisson|rush] [seed] [floors_added] [load] [lookups]
+*/
+
+static constexpr double EPOCH = 60;                     // simulated seconds between barriers
+static constexpr double MEAN_STAY = 2 * 3600;
+static constexpr double MIN_STAY = 5 * 60;
+static constexpr std::array<double, VEHICLE_TYPE_COUNT> MIX = {0.2, 0.6, 0.15, 0.05};
+
+// latency histogram with 16 sub-buckets per power of two of nanoseconds
+class LatencyHistogram
+{
+    static constexpr size_t SUB = 16;
+
+    std::array<uint64_t, 64 * SUB> counts_{};
+    uint64_t total_{0};
+    uint64_t max_{0};
+
+    static size_t bucket(uint64_t ns)
+    {
+        if(ns < SUB) return ns;
+        int e = std::bit_width(ns) - 1;
+        return (e - 3) * SUB + ((ns >> (e - 4)) & (SUB - 1));
+    }
+
+    // largest value that lands in bucket b
+    static uint64_t upper(size_t b)
+    {
+        if(b < SUB) return b;
+        size_t e = b / SUB + 3;
+        return ((SUB + b % SUB + 1) << (e - 4)) - 1;
+    }
+
+public:
+    void record(uint64_t ns)
+    {
+        ++counts_[bucket(ns)];
+        ++total_;
+        max_ = std::max(max_, ns);
+    }
+
+    void merge(const LatencyHistogram &other)
+    {
+        for(size_t b = 0; b < counts_.size(); ++b) counts_[b] += other.counts_[b];
+        total_ += other.total_;
+        max_ = std::max(max_, other.max_);
+    }
+
+    uint64_t percentile(double q) const
+    {
+        auto rank = static_cast<uint64_t>(std::ceil(q * total_));
+        uint64_t seen = 0;
+        for(size_t b = 0; b < counts_.size(); ++b) {
+            seen += counts_[b];
+            if(seen >= rank && seen > 0) return std::min(upper(b), max_);
+        }
+        return max_;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t max() const { return max_; }
+};
+
+// arrivals per second of one gate at simulated time t, mean 1 over a day
+class ArrivalProfile
+{
+    bool rush_;
+    double scale_{1};
+    double peak_{1};
+
+    double shape(double t) const
+    {
+        if(!rush_) return 1;
+        double h = std::fmod(t / 3600, 24);
+        auto bump = [h](double at, double width) { return std::exp(-(h - at) * (h - at) / (2 * width * width)); };
+        return 0.25 + 1.6 * bump(8.5, 0.9) + 1.3 * bump(17.5, 1.1);
+    }
+
+public:
+    explicit ArrivalProfile(bool rush) : rush_(rush)
+    {
+        double sum = 0, top = 0;
+        for(int m = 0; m < 24 * 60; ++m) {
+            sum += shape(m * 60.0);
+            top = std::max(top, shape(m * 60.0));
+        }
+        scale_ = 24 * 60 / sum;
+        peak_ = top * scale_ * 1.01;
+    }
+
+    double at(double t) const { return shape(t) * scale_; }
+    double peak() const { return peak_; }
+};
+
+// next arrival after t of a non-homogeneous Poisson process of rate * profile(t), by thinning
+static double next_arrival(double t, double rate, const ArrivalProfile &profile, std::mt19937_64 &rng)
+{
+    std::exponential_distribution<double> gap{rate * profile.peak()};
+    std::uniform_real_distribution<double> accept{0, profile.peak()};
+    do t += gap(rng);
+    while(accept(rng) > profile.at(t));
+    return t;
+}
+
+struct GateStats
+{
+    LatencyHistogram park, unpark, lookup;
+    size_t arrivals{0}, turned_away{0}, departures{0}, violations{0};
+};
+
+int main(int argc, char **argv)
+{
+    size_t gates = argc > 1 ? std::stoul(argv[1]) : 8;
+    double hours = argc > 2 ? std::stod(argv[2]) : 24;
+    bool rush = argc > 3 ? std::string{argv[3]} != "poisson" : true;
+    uint64_t seed = argc > 4 ? std::stoull(argv[4]) : 25;
+    size_t floors = argc > 5 ? std::stoul(argv[5]) : 9;
+    double load = argc > 6 ? std::stod(argv[6]) : 0.5;
+    size_t lookups = argc > 7 ? std::stoul(argv[7]) : 2;
+    if(gates == 0) return 2;
+
+    auto &lot = SingletonParkingLot::getInstance();
+    ZoneConfig zone;
+    for(size_t c = 0; c < SLOT_SIZE_COUNT; ++c) zone.slots[c] = SLOTS_PER_SIZE[c] / 2;
+    for(size_t f = 0; f < floors; ++f) lot.addFloor({zone, zone});
+    for(size_t g = 1; g < gates; ++g) {
+        lot.addGate(Position{static_cast<uint32_t>(g % (floors + 1)), static_cast<uint32_t>(g * 20 % 100)});
+    }
+
+    const ArrivalProfile profile{rush};
+    const double end = hours * 3600;
+    const double rate = load * lot.getCapacity() / MEAN_STAY / gates;        // per gate, per second
+
+    std::atomic<size_t> peak{0};
+    std::barrier sync{static_cast<std::ptrdiff_t>(gates), [&]() noexcept {
+        peak.store(std::max(peak.load(), static_cast<size_t>(lot.getOccupiedSlots())));
+    }};
+
+    std::vector<GateStats> stats(gates);
+    std::vector<std::thread> pool;
+    for(size_t g = 0; g < gates; ++g) {
+        pool.emplace_back([&, g] {
+            GateStats &s = stats[g];
+            std::mt19937_64 rng{seed * 1'000'003 + g};
+            std::exponential_distribution<double> stay{1 / MEAN_STAY};
+            std::discrete_distribution<size_t> mix{MIX.begin(), MIX.end()};
+
+            struct Departure
+            {
+                double time;
+                std::string plate;
+                VehicleRef vehicle;
+            };
+            auto later = [](const Departure &a, const Departure &b) { return a.time > b.time; };
+            std::vector<Departure> parked;                  // min-heap on departure time
+            // the next arrival, infinity once the simulated time is up
+            auto after = [&](double t) {
+                t = next_arrival(t, rate, profile, rng);
+                return t < end ? t : INFINITY;
+            };
+            double arrival = after(0);
+
+            auto timed = [](LatencyHistogram &histogram, auto op) {
+                auto start = std::chrono::steady_clock::now();
+                auto result = op();
+                histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+                return result;
+            };
+
+            auto depart = [&] {
+                std::pop_heap(parked.begin(), parked.end(), later);
+                Departure d = std::move(parked.back());
+                parked.pop_back();
+                auto departure = timed(s.unpark, [&] { return lot.ExitVehicle(d.plate); });
+                if(!departure || !(departure->vehicle == d.vehicle)) ++s.violations;
+                VehicleFactory::destroyVehicle(d.vehicle);
+                ++s.departures;
+            };
+
+            for(double epoch_end = EPOCH; epoch_end - EPOCH < end; epoch_end += EPOCH) {
+                for(;;) {
+                    bool leaving = !parked.empty() && parked.front().time < std::min(arrival, epoch_end);
+                    if(leaving) {
+                        depart();
+                        continue;
+                    }
+                    if(arrival >= epoch_end) break;
+
+                    auto type = static_cast<VehicleType>(mix(rng));
+                    auto plate = "G" + std::to_string(g) + "-" + std::to_string(++s.arrivals);
+                    double leaves = arrival + std::max(MIN_STAY, stay(rng));
+                    auto vehicle = VehicleFactory::createVehicle(type, plate);
+                    auto ticket = timed(s.park, [&] { return lot.EnterVehicle(vehicle, g); });
+                    if(ticket) {
+                        parked.push_back(Departure{leaves, plate, vehicle});
+                        std::push_heap(parked.begin(), parked.end(), later);
+                    }
+                    else {
+                        VehicleFactory::destroyVehicle(vehicle);
+                        ++s.turned_away;
+                    }
+
+                    for(size_t i = 0; i < lookups; ++i) {
+                        size_t pick = rng();
+                        if(parked.empty()) continue;
+                        auto &d = parked[pick % parked.size()];
+                        auto found = timed(s.lookup, [&] { return lot.findVehicle(d.plate); });
+                        if(!found) ++s.violations;
+                    }
+                    arrival = after(arrival);
+                }
+                sync.arrive_and_wait();
+            }
+
+            // the simulated day is over: everyone still parked leaves, untimed
+            for(auto &d : parked) {
+                auto departure = lot.ExitVehicle(d.plate);
+                if(!departure || !(departure->vehicle == d.vehicle)) ++s.violations;
+                VehicleFactory::destroyVehicle(d.vehicle);
+            }
+        });
+    }
+    for(auto &th : pool) th.join();
+
+    GateStats total;
+    for(auto &s : stats) {
+        total.park.merge(s.park);
+        total.unpark.merge(s.unpark);
+        total.lookup.merge(s.lookup);
+        total.arrivals += s.arrivals;
+        total.turned_away += s.turned_away;
+        total.departures += s.departures;
+        total.violations += s.violations;
+    }
+    if(lot.getOccupiedSlots() != 0) ++total.violations;
+
+    std::cout << "profile,gates,hours,seed,capacity,arrivals,turned_away,departures,peak_occupied,violations\n";
+    std::cout << (rush ? "rush" : "poisson") << "," << gates << "," << hours << "," << seed << ","
+              << lot.getCapacity() << "," << total.arrivals << "," << total.turned_away << "," << total.departures
+              << "," << peak << "," << total.violations << "\n";
+    std::cout << "op,count,p50_ns,p99_ns,p999_ns,max_ns\n";
+    for(auto [name, histogram] : {std::pair<const char*, const LatencyHistogram*>{"park", &total.park},
+                                  std::pair<const char*, const LatencyHistogram*>{"unpark", &total.unpark},
+                                  std::pair<const char*, const LatencyHistogram*>{"lookup", &total.lookup}}) {
+        std::cout << name << "," << histogram->count() << "," << histogram->percentile(0.5) << ","
+                  << histogram->percentile(0.99) << "," << histogram->percentile(0.999) << "," << histogram->max()
+                  << "\n";
+    }
+    return total.violations == 0 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// Fixed-size object pool for one type, addressed by 32-bit index
+/*
+    Objects live in slabs of SLAB entries that never move or shrink while the pool lives, so an index stays
+    valid from create to destroy without any lock and get() is one array lookup. Free entries form a lock-free
+    stack (Treiber) whose head carries a tag that changes on every pop, so a thread holding a stale head cannot
+    swing it (no ABA). create and destroy are O(1); a new slab is only allocated, under a mutex, when the
+    stack runs dry. Memory is returned to the system when the pool is destroyed, not before.
+*/
+template<typename T>
+class SlabPool
+{
+public:
+    static constexpr size_t SLAB = 1024;
+    static constexpr size_t MAX_SLABS = 16384;          // 16M objects
+
+private:
+    struct Slab
+    {
+        alignas(T) unsigned char storage[SLAB][sizeof(T)];
+        std::atomic<uint32_t> next[SLAB];               // free stack link: index + 1, 0 = end
+    };
+
+    std::array<std::atomic<Slab*>, MAX_SLABS> slabs_{};
+    size_t slab_count_{0};                              // guarded by grow_mtx_
+    alignas(64) std::atomic<uint64_t> free_head_{0};    // tag << 32 | (index + 1)
+    mutable std::mutex grow_mtx_;
+
+    Slab& slab_of(uint32_t index) const
+    {
+        return *slabs_[index / SLAB].load(std::memory_order_acquire);
+    }
+
+    std::atomic<uint32_t>& link(uint32_t index) const
+    {
+        return slab_of(index).next[index % SLAB];
+    }
+
+    // pushes the chain first..last (already linked) onto the free stack
+    void push(uint32_t first, uint32_t last)
+    {
+        uint64_t head = free_head_.load(std::memory_order_relaxed);
+        do {
+            link(last).store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        } while(!free_head_.compare_exchange_weak(head, (head & ~uint64_t{UINT32_MAX}) | (first + 1),
+                                                  std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    bool pop(uint32_t &index)
+    {
+        uint64_t head = free_head_.load(std::memory_order_acquire);
+        for(;;) {
+            auto top = static_cast<uint32_t>(head);
+            if(top == 0) return false;
+            uint32_t next = link(top - 1).load(std::memory_order_relaxed);
+            uint64_t tagged = ((head >> 32) + 1) << 32 | next;
+            if(free_head_.compare_exchange_weak(head, tagged, std::memory_order_acquire)) {
+                index = top - 1;
+                return true;
+            }
+        }
+    }
+
+    void grow()
+    {
+        std::scoped_lock<std::mutex> lock{grow_mtx_};
+        if(static_cast<uint32_t>(free_head_.load()) != 0) return;       // somebody else just grew it
+        if(slab_count_ == MAX_SLABS) throw std::length_error("SlabPool: out of slabs");
+
+        auto slab = new Slab;
+        auto base = static_cast<uint32_t>(slab_count_ * SLAB);
+        for(uint32_t i = 0; i + 1 < SLAB; ++i) slab->next[i].store(base + i + 2, std::memory_order_relaxed);
+        slab->next[SLAB - 1].store(0, std::memory_order_relaxed);
+        slabs_[slab_count_++].store(slab, std::memory_order_release);
+        push(base, base + SLAB - 1);
+    }
+
+public:
+    SlabPool() = default;
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    // objects still alive are not destroyed, only their memory is released
+    ~SlabPool()
+    {
+        for(auto &slab : slabs_) delete slab.load();
+    }
+
+    template<typename... Args>
+    uint32_t create(Args&&... args)
+    {
+        uint32_t index;
+        while(!pop(index)) grow();
+        new (slab_of(index).storage[index % SLAB]) T(std::forward<Args>(args)...);
+        return index;
+    }
+
+    T* get(uint32_t index) const
+    {
+        return std::launder(reinterpret_cast<T*>(slab_of(index).storage[index % SLAB]));
+    }
+
+    void destroy(uint32_t index)
+    {
+        get(index)->~T();
+        push(index, index);
+    }
+
+    size_t capacity() const
+    {
+        std::scoped_lock<std::mutex> lock{grow_mtx_};
+        return slab_count_ * SLAB;
+    }
+};
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "vehicle.hpp"
+#include "free_bitmap.hpp"
+
+// Slot size classes, smallest first: a vehicle fits its own class and every larger one
+enum class SlotSize : uint8_t
+{
+    Small,          // motorcycles
+    Compact,        // cars
+    Large,          // trucks
+    XLarge          // buses
+};
+
+static constexpr size_t SLOT_SIZE_COUNT = 4;
+static constexpr size_t VEHICLE_TYPE_COUNT = 4;
+
+inline SlotSize slot_size_for(VehicleType type)
+{
+    switch(type)
+    {
+    case VehicleType::Motorcycle: return SlotSize::Small;
+    case VehicleType::Car: return SlotSize::Compact;
+    case VehicleType::Truck: return SlotSize::Large;
+    case VehicleType::Bus: return SlotSize::XLarge;
+    }
+    return SlotSize::XLarge;
+}
+
+// Slots of one size class, stored as parallel arrays
+/*
+    Struct of arrays: occupancy lives only in the FreeBitmap (bit clear = occupied) and every slot is the
+    32-bit VehicleHandle of the pooled vehicle parked there. A slot's ID is implied by its position,
+    first_id() + index. That is 4 bytes and a bit per slot instead of a slot object with an ID, a shared_ptr and a state,
+    and an occupancy scan reads 64 slots per bitmap word and 16 handles per cache line.
+
+    The handle word doubles as the slot state: park stores it once the bitmap has handed out the slot, and
+    unpark exchanges it with NO_VEHICLE, so exactly one exit gets the vehicle; the slot goes back to the
+    bitmap only after that. borrowed counts slots held by a vehicle of a smaller class that spilled over
+    because its own class was full.
+*/
+class SlotPool
+{
+    SlotSize size_class_;
+    size_t first_id_;
+    size_t size_;
+    FreeBitmap free_;
+    std::unique_ptr<std::atomic<VehicleHandle>[]> vehicles_;
+    alignas(64) std::atomic<size_t> borrowed_{0};
+
+public:
+    SlotPool(SlotSize size_class, size_t count, size_t first_id)
+        : size_class_(size_class), first_id_(first_id), size_(count), free_(count),
+          vehicles_(new std::atomic<VehicleHandle>[count])
+    {
+        for(size_t i = 0; i < count; ++i) vehicles_[i].store(NO_VEHICLE, std::memory_order_relaxed);
+    }
+
+    SlotPool(const SlotPool&) = delete;
+    SlotPool& operator=(const SlotPool&) = delete;
+
+    // parks the vehicle in a free slot of this pool, returns the slot index; on_claimed(index) runs once the
+    // slot is taken but before the vehicle is visible in it, so before anyone can unpark it
+    template<typename OnClaimed>
+    std::optional<size_t> park(VehicleRef vehicle, size_t hint, OnClaimed &&on_claimed)
+    {
+        auto idx = free_.acquire(hint);
+        if(!idx) return std::nullopt;
+
+        VehicleHandle handle = vehicle.handle();
+        if(slot_size_for(handle_type(handle)) != size_class_) borrowed_.fetch_add(1, std::memory_order_relaxed);
+        on_claimed(*idx);
+        vehicles_[*idx].store(handle, std::memory_order_release);
+        return idx;
+    }
+
+    std::optional<size_t> park(VehicleRef vehicle, size_t hint)
+    {
+        return park(vehicle, hint, [](size_t) {});
+    }
+
+    // empty ref if the slot was not occupied; on_taken(vehicle) runs once the vehicle is out of the slot but
+    // before the slot can be handed to the next parker
+    template<typename OnTaken>
+    VehicleRef unpark(size_t idx, OnTaken &&on_taken)
+    {
+        VehicleHandle handle = vehicles_[idx].exchange(NO_VEHICLE, std::memory_order_acq_rel);
+        if(handle == NO_VEHICLE) return VehicleRef{};
+
+        if(slot_size_for(handle_type(handle)) != size_class_) borrowed_.fetch_sub(1, std::memory_order_relaxed);
+        on_taken(VehicleRef{handle});
+        free_.release(idx);
+        return VehicleRef{handle};
+    }
+
+    VehicleRef unpark(size_t idx)
+    {
+        return unpark(idx, [](VehicleRef) {});
+    }
+
+    // puts the vehicle into slot idx itself (recovery), false if the slot is taken
+    bool place(size_t idx, VehicleRef vehicle)
+    {
+        if(!hold(idx)) return false;
+        fill(idx, vehicle);
+        return true;
+    }
+
+    // takes slot idx out of the free bitmap with no vehicle in it (a reservation keeping it), false if taken;
+    // nobody else can park there or unpark it until fill() or unhold()
+    bool hold(size_t idx)
+    {
+        return free_.claim(idx);
+    }
+
+    // puts the vehicle into slot idx, which the caller holds
+    void fill(size_t idx, VehicleRef vehicle)
+    {
+        VehicleHandle handle = vehicle.handle();
+        if(slot_size_for(handle_type(handle)) != size_class_) borrowed_.fetch_add(1, std::memory_order_relaxed);
+        vehicles_[idx].store(handle, std::memory_order_release);
+    }
+
+    // gives back slot idx, which the caller holds and has not filled
+    void unhold(size_t idx)
+    {
+        free_.release(idx);
+    }
+
+    // vehicle parked in slot idx, empty ref if none
+    VehicleRef vehicle(size_t idx) const
+    {
+        return VehicleRef{vehicles_[idx].load(std::memory_order_acquire)};
+    }
+
+    // parked vehicles per VehicleType, from the bitmap and the handle array only
+    void count_by_type(std::array<size_t, VEHICLE_TYPE_COUNT> &counts) const
+    {
+        if(size_ == 0) return;
+        for(size_t w = 0; w < free_.word_count(); ++w) {
+            uint64_t occupied = ~free_.word(w);
+            if(w + 1 == free_.word_count() && size_ % 64) occupied &= (uint64_t{1} << (size_ % 64)) - 1;
+            while(occupied) {
+                size_t idx = w * 64 + std::countr_zero(occupied);
+                occupied &= occupied - 1;
+                VehicleHandle handle = vehicles_[idx].load(std::memory_order_acquire);
+                if(handle != NO_VEHICLE) ++counts[static_cast<size_t>(handle_type(handle))];
+            }
+        }
+    }
+
+    bool contains(size_t slotID) const
+    {
+        return slotID >= first_id_ && slotID - first_id_ < size_;
+    }
+
+    size_t first_id() const { return first_id_; }
+    size_t slot_id(size_t idx) const { return first_id_ + idx; }
+
+    SlotSize size_class() const { return size_class_; }
+    size_t size() const { return size_; }
+    size_t available() const { return free_.free_count(); }
+    size_t occupied() const { return size_ - free_.free_count(); }
+    size_t borrowed() const { return borrowed_.load(std::memory_order_relaxed); }
+
+    size_t memory_bytes() const
+    {
+        return sizeof(*this) + size_ * sizeof(VehicleHandle) + free_.memory_bytes() - sizeof(FreeBitmap);
+    }
+};
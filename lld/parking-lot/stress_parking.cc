@@ -0,0 +1,185 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "parking_lot.hpp"
+
+/*
+    Concurrency stress test for SingletonParkingLot: every thread is an entry/exit gate that parks vehicles
+    of random types and unparks the ones it parked, in random order, so the lot keeps filling up and draining
+    and smaller vehicles keep spilling over into larger classes. Meanwhile the main thread adds floors to the
+    running lot.
+
+    Every slot has an owner word outside the lot. A gate that is handed a slot swaps its own id in and must
+    find the slot unowned, and swaps it out again before unparking; the vehicle it gets back must be the one
+    it parked, and it then returns the vehicle to its pool. Any mismatch is a double assignment or a lost
+    vehicle and is counted as a violation. At the end the lot must be empty again (no borrowed slot left
+    over) and a single gate must be able to fill every slot with motorcycles, which fit every class.
+
+    The lot raises capacity alerts (10% / 5%) throughout; the per-floor and per-type counters must read 0
+    once the gates have drained the lot, and the refill must raise exactly one more alert and clear it.
+
+    Every other vehicle goes through the ticketed EnterVehicle/ExitVehicle instead, with a unique plate: the
+    plate index must find it right after entry, refuse a second vehicle with the same plate, hand back the
+    right slot and vehicle on exit and forget the plate afterwards. Every ticketed exit must have closed
+    exactly one ticket.
+
+    build: g++ -std=c++20 -O1 -g -pthread -fsanitize=thread stress_parking.cc -o stress_parking
+    run:   ./stress_parking [gates] [seconds] [floors_added]
+*/
+
+int main(int argc, char **argv)
+{
+    size_t gates = argc > 1 ? std::stoul(argv[1]) : 8;
+    double seconds = argc > 2 ? std::stod(argv[2]) : 2.0;
+    size_t floors = argc > 3 ? std::stoul(argv[3]) : 4;
+
+    auto &lot = SingletonParkingLot::getInstance();
+    const size_t capacity = PARKING_LOT_SIZE * (1 + floors);
+    std::vector<std::atomic<size_t>> owners(capacity + 1);             // by slot ID, 0 = unowned
+
+    ZoneConfig zone;
+    for(size_t c = 0; c < SLOT_SIZE_COUNT; ++c) zone.slots[c] = SLOTS_PER_SIZE[c] / 2;
+
+    // a few entry gates spread over the ground floor and the floors to come
+    const size_t lot_gates = 4;
+    for(uint32_t g = 1; g < lot_gates; ++g) lot.addGate(Position{g, g * 20});
+
+    // capacity alerts: every NEAR_CAPACITY must be matched by one CAPACITY_OK once the lot has drained
+    struct AlertCount : Observer<ParkingLot>
+    {
+        std::atomic<size_t> near{0}, ok{0};
+
+        void field_changed(ParkingLot&, FieldId field) override
+        {
+            if(field == ParkingLot::NEAR_CAPACITY) ++near;
+            if(field == ParkingLot::CAPACITY_OK) ++ok;
+        }
+    } alerts;
+    lot.subscribe(alerts);
+    lot.setCapacityAlert(0.1, 0.05);
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> parks{0}, unparks{0}, full{0}, violations{0}, exits{0};
+
+    std::vector<std::thread> pool;
+    for(size_t g = 0; g < gates; ++g) {
+        pool.emplace_back([&, g] {
+            const size_t me = g + 1;
+            std::mt19937 rng{static_cast<unsigned>(me)};
+            struct Parked
+            {
+                size_t slot;
+                VehicleRef vehicle;
+                bool ticketed;
+            };
+            std::vector<Parked> mine;
+            size_t parked = 0, left = 0, rejected = 0, bad = 0, plates = 0, ticketed_exits = 0;
+
+            auto unpark_one = [&] {
+                size_t i = rng() % mine.size();
+                auto [slot, vehicle, ticketed] = mine[i];
+                mine[i] = mine.back();
+                mine.pop_back();
+                if(owners[slot].exchange(0) != me) ++bad;
+                if(ticketed) {
+                    auto departure = lot.ExitVehicle(vehicle->getRegNo());
+                    if(!departure || departure->ticket.slot != slot || !(departure->vehicle == vehicle)) ++bad;
+                    if(lot.findVehicle(vehicle->getRegNo())) ++bad;
+                    ++ticketed_exits;
+                }
+                else if(!(lot.UnparkVehicle(slot) == vehicle)) ++bad;
+                VehicleFactory::destroyVehicle(vehicle);
+                ++left;
+            };
+
+            while(!stop.load(std::memory_order_relaxed)) {
+                if(!mine.empty() && rng() % 2) {
+                    unpark_one();
+                    continue;
+                }
+                auto type = static_cast<VehicleType>(rng() % 4);
+                auto plate = "G" + std::to_string(me) + "-" + std::to_string(++plates);
+                auto vehicle = VehicleFactory::createVehicle(type, plate);
+                bool ticketed = plates % 2;
+                std::optional<size_t> slot;
+                if(ticketed) {
+                    if(auto ticket = lot.EnterVehicle(vehicle, g % lot_gates)) {
+                        slot = ticket->slot;
+                        auto found = lot.findVehicle(plate);
+                        if(!found || found->id != ticket->id || found->slot != ticket->slot) ++bad;
+
+                        // the same plate must not get in twice
+                        auto twin = VehicleFactory::createVehicle(VehicleType::Motorcycle, plate);
+                        if(lot.EnterVehicle(twin)) ++bad;
+                        VehicleFactory::destroyVehicle(twin);
+                    }
+                }
+                else slot = lot.ParkVehcile(vehicle, g % lot_gates);
+                if(!slot) {
+                    VehicleFactory::destroyVehicle(vehicle);
+                    ++rejected;
+                    if(!mine.empty()) unpark_one();
+                    continue;
+                }
+                if(*slot == 0 || *slot > capacity || owners[*slot].exchange(me) != 0) ++bad;
+                mine.push_back(Parked{*slot, vehicle, ticketed});
+                ++parked;
+            }
+            while(!mine.empty()) unpark_one();
+
+            parks += parked;
+            unparks += left;
+            full += rejected;
+            violations += bad;
+            exits += ticketed_exits;
+        });
+    }
+
+    for(size_t f = 1; f <= floors; ++f) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds / (floors + 1)));
+        lot.addFloor({zone, zone});
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds / (floors + 1)));
+    stop = true;
+    for(auto &th : pool) th.join();
+
+    if(lot.getCapacity() != capacity || lot.getAvailableSlots() != capacity) ++violations;
+    for(auto size : {SlotSize::Small, SlotSize::Compact, SlotSize::Large, SlotSize::XLarge}) {
+        auto occupancy = lot.getOccupancy(size);
+        if(occupancy.occupied != 0 || occupancy.borrowed != 0) ++violations;
+    }
+
+    // the sharded counters must agree with the bitmaps
+    if(lot.getOccupiedSlots() != 0) ++violations;
+    for(uint32_t f = 0; f <= floors; ++f) {
+        if(lot.getFloorOccupancy(f) != 0) ++violations;
+    }
+
+    // one billed ticket per ticketed exit; refused twins are voided, not billed
+    auto &tickets = lot.tickets();
+    if(tickets.settle(1, tickets.size() + 1, FixedRateFeeCalculator{{1, 1, 1, 1}}).billed != exits) ++violations;
+
+    // every slot must still be reachable through the bitmap summaries: a full refill has to succeed
+    auto bike = VehicleFactory::createVehicle(VehicleType::Motorcycle, "REFILL");
+    std::vector<size_t> refill;
+    while(auto slot = lot.ParkVehcile(bike)) refill.push_back(*slot);
+    if(refill.size() != capacity || lot.getOccupiedSlots(VehicleType::Motorcycle) != capacity) ++violations;
+    if(!lot.isNearCapacity()) ++violations;
+    for(size_t slot : refill) lot.UnparkVehicle(slot);
+    VehicleFactory::destroyVehicle(bike);
+    if(lot.isNearCapacity() || alerts.near == 0 || alerts.near != alerts.ok) ++violations;
+    lot.unsubscribe(alerts);
+
+    std::cout << "gates,floors,parks,unparks,lot_full,alerts,available_after,violations\n";
+    std::cout << gates << "," << floors + 1 << "," << parks << "," << unparks << "," << full << "," << alerts.near << ","
+              << lot.getAvailableSlots() << "," << violations << "\n";
+    return violations == 0 ? 0 : 1;
+}
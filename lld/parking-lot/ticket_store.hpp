@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "vehicle.hpp"
+#include "fee_calculator.hpp"
+
+// Ticket store: every ticket ever issued, in packed columns
+/*
+    Ticket id n lives at index n - 1 of four column arrays: entry time, exit time, slot ID and VehicleType,
+    split into chunks of CHUNK tickets that never move (a new chunk is allocated, under a mutex, by the first
+    issue that needs it). Times are 32-bit seconds since the store's epoch, the start of the day it was
+    created. A fee pass therefore streams three dense arrays instead of chasing one object per ticket.
+    now() reads the wall clock once, at construction, and advances with steady_clock from there, so a wall
+    clock step (NTP, an admin) cannot give an exit before its entry; close() clamps such an exit to the entry
+    anyway, for times that come from elsewhere.
+
+    Tickets are bucketed by entry day: ids are issued in entry order, so a day is the id range from its first
+    ticket to the next day's first (a ticket issued concurrently right at midnight may land on either side),
+    and end-of-day settlement is one pass over that range.
+
+    issue() and close() are safe from any number of gate threads. settle() reads the columns without
+    synchronisation: run it over a range no gate is still closing tickets in (e.g. days that have ended).
+
+    Recovery after a restart (ParkingLot::restore) brings back the tickets of vehicles still parked: rebase()
+    moves the epoch of a store that has not issued anything yet back to the earliest entry, and reissue()
+    files each ticket under its old id, the ids skipped in between as void, so new tickets continue after
+    the old ones. Both run before any gate does.
+*/
+class TicketStore
+{
+public:
+    static constexpr size_t CHUNK = 1 << 16;
+    static constexpr size_t MAX_CHUNKS = 1 << 14;                   // 1G tickets
+    static constexpr uint32_t DAY = 24 * 60 * 60;
+
+    // exit column markers: still parked / never billed (the entry was refused after the ticket was issued)
+    static constexpr uint32_t OPEN = UINT32_MAX;
+    static constexpr uint32_t VOID = UINT32_MAX - 1;
+
+    struct Settlement
+    {
+        size_t tickets{0};          // in the range
+        size_t billed{0};           // closed, i.e. with a fee
+        uint64_t revenue{0};        // cents
+    };
+
+private:
+    struct Chunk
+    {
+        uint32_t entry[CHUNK];
+        uint32_t exit[CHUNK];
+        uint32_t slot[CHUNK];
+        uint8_t type[CHUNK];
+    };
+
+    std::chrono::system_clock::time_point epoch_;
+    std::chrono::steady_clock::time_point started_;                 // when the store was created
+    std::chrono::system_clock::duration started_at_;                // ... in time since epoch_
+    std::array<std::atomic<Chunk*>, MAX_CHUNKS> chunks_{};
+    alignas(64) std::atomic<uint64_t> issued_{0};
+    alignas(64) std::atomic<uint32_t> last_day_{0};
+
+    mutable std::mutex mtx_;                                        // chunk allocation, day_first_
+    std::vector<uint64_t> day_first_{1};                            // first ticket id of every day since epoch
+
+    Chunk& chunk_of(size_t index)
+    {
+        auto &chunk = chunks_[index / CHUNK];
+        if(Chunk *c = chunk.load(std::memory_order_acquire)) return *c;
+
+        std::scoped_lock<std::mutex> lock{mtx_};
+        if(chunk.load(std::memory_order_relaxed) == nullptr) chunk.store(new Chunk, std::memory_order_release);
+        return *chunk.load(std::memory_order_relaxed);
+    }
+
+    const Chunk& chunk_of(size_t index) const
+    {
+        return *chunks_[index / CHUNK].load(std::memory_order_acquire);
+    }
+
+    // id is the first ticket seen entering on day (or later): open the buckets up to it
+    void start_day(uint32_t day, uint64_t id)
+    {
+        std::scoped_lock<std::mutex> lock{mtx_};
+        while(day_first_.size() <= day) day_first_.push_back(id);
+        if(last_day_.load(std::memory_order_relaxed) < day) last_day_.store(day, std::memory_order_relaxed);
+    }
+
+public:
+    explicit TicketStore(std::chrono::system_clock::time_point now = std::chrono::system_clock::now())
+        : epoch_(std::chrono::floor<std::chrono::days>(now)), started_(std::chrono::steady_clock::now()),
+          started_at_(now - epoch_)
+    {
+    }
+
+    ~TicketStore()
+    {
+        for(auto &chunk : chunks_) delete chunk.load();
+    }
+
+    TicketStore(const TicketStore&) = delete;
+    TicketStore& operator=(const TicketStore&) = delete;
+
+    // seconds since the epoch, the store's unit of time; never goes back
+    uint32_t now() const
+    {
+        auto since = started_at_ + (std::chrono::steady_clock::now() - started_);
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::seconds>(since).count());
+    }
+
+    // the store's time t in seconds since the Unix epoch, and back (clamped to the store's range)
+    int64_t unix_time(uint32_t t) const
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(epoch_.time_since_epoch()).count() + t;
+    }
+
+    uint32_t store_time(int64_t unix_seconds) const
+    {
+        int64_t t = unix_seconds - unix_time(0);
+        return static_cast<uint32_t>(std::clamp<int64_t>(t, 0, VOID - 1));
+    }
+
+    // recovery: moves the epoch back to the start of the day of unix_seconds if that is earlier, so times from
+    // then on can be represented; false (and nothing changes) once a ticket has been issued
+    bool rebase(int64_t unix_seconds)
+    {
+        if(size() != 0) return false;
+        auto day = std::chrono::floor<std::chrono::days>(
+            std::chrono::system_clock::time_point{std::chrono::seconds{unix_seconds}});
+        if(day < epoch_) {
+            started_at_ += epoch_ - day;
+            epoch_ = day;
+        }
+        return true;
+    }
+
+    // recovery, single threaded: files a ticket under id, which must be above every id issued so far (false
+    // otherwise); the ids in between become void tickets
+    bool reissue(uint64_t id, size_t slot, VehicleType type, uint32_t entry)
+    {
+        uint64_t index = issued_.load(std::memory_order_relaxed);
+        if(id <= index || (id - 1) / CHUNK >= MAX_CHUNKS) return false;
+
+        for(; index + 1 < id; ++index) {
+            Chunk &chunk = chunk_of(index);
+            chunk.entry[index % CHUNK] = entry;
+            chunk.exit[index % CHUNK] = VOID;
+            chunk.slot[index % CHUNK] = 0;
+            chunk.type[index % CHUNK] = 0;
+        }
+        issued_.store(index, std::memory_order_relaxed);
+        return issue(slot, type, entry) == id;
+    }
+
+    // returns the new ticket's id (from 1)
+    uint64_t issue(size_t slot, VehicleType type, uint32_t entry)
+    {
+        uint64_t index = issued_.fetch_add(1, std::memory_order_relaxed);
+        if(index / CHUNK >= MAX_CHUNKS) throw std::length_error("TicketStore: out of chunks");
+
+        Chunk &chunk = chunk_of(index);
+        chunk.entry[index % CHUNK] = entry;
+        chunk.exit[index % CHUNK] = OPEN;
+        chunk.slot[index % CHUNK] = static_cast<uint32_t>(slot);
+        chunk.type[index % CHUNK] = static_cast<uint8_t>(type);
+
+        if(entry / DAY > last_day_.load(std::memory_order_relaxed)) start_day(entry / DAY, index + 1);
+        return index + 1;
+    }
+
+    // exit at time exit, at the earliest the entry time (use VOID to cancel a ticket that is never to be billed)
+    void close(uint64_t id, uint32_t exit)
+    {
+        Chunk &chunk = chunk_of(id - 1);
+        size_t i = (id - 1) % CHUNK;
+        chunk.exit[i] = exit >= VOID ? VOID : std::max(exit, chunk.entry[i]);
+    }
+
+    uint32_t entry(uint64_t id) const { return chunk_of(id - 1).entry[(id - 1) % CHUNK]; }
+    uint32_t exit(uint64_t id) const { return chunk_of(id - 1).exit[(id - 1) % CHUNK]; }
+    size_t slot(uint64_t id) const { return chunk_of(id - 1).slot[(id - 1) % CHUNK]; }
+    VehicleType type(uint64_t id) const { return static_cast<VehicleType>(chunk_of(id - 1).type[(id - 1) % CHUNK]); }
+
+    size_t size() const { return issued_.load(std::memory_order_acquire); }
+
+    // ticket ids [first, last) that entered on day (days since the epoch)
+    std::pair<uint64_t, uint64_t> day_range(uint32_t day) const
+    {
+        std::scoped_lock<std::mutex> lock{mtx_};
+        uint64_t end = size() + 1;
+        if(day >= day_first_.size()) return {end, end};
+        return {day_first_[day], day + 1 < day_first_.size() ? day_first_[day + 1] : end};
+    }
+
+    // fees of tickets [first, last): one FeeCalculator batch per chunk, open and void tickets bill nothing
+    Settlement settle(uint64_t first, uint64_t last, const FeeCalculator &calculator) const
+    {
+        Settlement total;
+        std::vector<uint32_t> fees(CHUNK);
+        for(uint64_t index = first - 1; index < last - 1;) {
+            const Chunk &chunk = chunk_of(index);
+            size_t from = index % CHUNK;
+            size_t n = std::min<uint64_t>(CHUNK - from, last - 1 - index);
+
+            std::span<const uint32_t> exit{chunk.exit + from, n};
+            calculator.fees({chunk.entry + from, n}, exit, {chunk.type + from, n}, {fees.data(), n});
+
+            uint64_t revenue = 0;
+            size_t billed = 0;
+            for(size_t i = 0; i < n; ++i) {
+                bool closed = exit[i] < VOID;
+                revenue += closed ? fees[i] : 0;
+                billed += closed;
+            }
+            total.tickets += n;
+            total.billed += billed;
+            total.revenue += revenue;
+            index += n;
+        }
+        return total;
+    }
+};
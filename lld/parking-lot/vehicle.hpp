@@ -1,7 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <string_view>
+
+#include "slab_pool.hpp"
 
 enum class VehicleType
 {
@@ -11,22 +17,53 @@ enum class VehicleType
     Bus
 };
 
+// Registration number stored inline, zero padded: no heap allocation, fixed 16 bytes
+class PlateNumber
+{
+public:
+    static constexpr size_t MAX_LENGTH = 15;
+
+private:
+    char chars_[MAX_LENGTH]{};
+    uint8_t length_{0};
+
+public:
+    PlateNumber() = default;
+
+    // longer numbers are cut to MAX_LENGTH, VehicleFactory refuses them before that can happen
+    explicit PlateNumber(std::string_view regNo) : length_(static_cast<uint8_t>(std::min(regNo.size(), MAX_LENGTH)))
+    {
+        std::memcpy(chars_, regNo.data(), length_);
+    }
+
+    std::string_view view() const
+    {
+        return std::string_view{chars_, length_};
+    }
+
+    bool operator==(const PlateNumber &other) const
+    {
+        return std::memcmp(this, &other, sizeof(PlateNumber)) == 0;
+    }
+};
+
 struct Vehicle
 {
-    virtual const std::string& getRegNo() const = 0;
+    virtual ~Vehicle() = default;
+    virtual std::string_view getRegNo() const = 0;
     virtual VehicleType getVehicleType() const = 0;
 };
 
 class Car : public Vehicle
 {
 private:
-    std::string regNo_;
+    PlateNumber regNo_;
     VehicleType type_;
 public:
-    Car(const std::string& regNo) : regNo_(regNo), type_(VehicleType::Car) {}
+    Car(std::string_view regNo) : regNo_(regNo), type_(VehicleType::Car) {}
 
-    const std::string& getRegNo() const override {
-        return regNo_;
+    std::string_view getRegNo() const override {
+        return regNo_.view();
     }
 
     VehicleType getVehicleType() const override {
@@ -34,25 +71,163 @@ public:
     }
 };
 
+class Motorcycle : public Vehicle
+{
+private:
+    PlateNumber regNo_;
+    VehicleType type_;
+public:
+    Motorcycle(std::string_view regNo) : regNo_(regNo), type_(VehicleType::Motorcycle) {}
+
+    std::string_view getRegNo() const override {
+        return regNo_.view();
+    }
+
+    VehicleType getVehicleType() const override {
+        return type_;
+    }
+};
+
+class Truck : public Vehicle
+{
+private:
+    PlateNumber regNo_;
+    VehicleType type_;
+public:
+    Truck(std::string_view regNo) : regNo_(regNo), type_(VehicleType::Truck) {}
+
+    std::string_view getRegNo() const override {
+        return regNo_.view();
+    }
+
+    VehicleType getVehicleType() const override {
+        return type_;
+    }
+};
+
+class Bus : public Vehicle
+{
+private:
+    PlateNumber regNo_;
+    VehicleType type_;
+public:
+    Bus(std::string_view regNo) : regNo_(regNo), type_(VehicleType::Bus) {}
+
+    std::string_view getRegNo() const override {
+        return regNo_.view();
+    }
+
+    VehicleType getVehicleType() const override {
+        return type_;
+    }
+};
+
+// 32-bit vehicle handle: low 30 bits index + 1 into the pool of its type (0 = no vehicle), top 2 bits the VehicleType
+/*
+    Keeping the type in the handle lets occupancy reports and size-class bookkeeping run on the slot arrays
+    alone, without following a pointer to every parked Vehicle.
+*/
+using VehicleHandle = uint32_t;
+
+static constexpr VehicleHandle NO_VEHICLE = 0;
+static constexpr VehicleHandle HANDLE_INDEX_MASK = (VehicleHandle{1} << 30) - 1;
+
+inline VehicleType handle_type(VehicleHandle handle)
+{
+    return static_cast<VehicleType>(handle >> 30);
+}
+
+// Lightweight, copyable reference to a pooled vehicle; does not own it (see VehicleFactory::destroyVehicle)
+class VehicleRef
+{
+    VehicleHandle handle_{NO_VEHICLE};
+
+public:
+    VehicleRef() = default;
+    explicit VehicleRef(VehicleHandle handle) : handle_(handle) {}
+
+    Vehicle* get() const;
+    Vehicle* operator->() const { return get(); }
+    Vehicle& operator*() const { return *get(); }
+
+    explicit operator bool() const { return handle_ != NO_VEHICLE; }
+    bool operator==(const VehicleRef &other) const { return handle_ == other.handle_; }
+
+    VehicleHandle handle() const { return handle_; }
+    VehicleType type() const { return handle_type(handle_); }
+};
+
+// Factory over per-type slab pools
+/*
+    Every VehicleType has its own SlabPool of fixed-size objects, so an arrival costs a pop from a lock-free
+    free list and an in-place construction (no heap allocation, no shared_ptr control block, the plate is
+    stored inline) and an exit is one push. Vehicles are still used polymorphically through Vehicle.
+*/
 struct VehicleFactory
 {
-    static std::shared_ptr<Vehicle> createVehicle(VehicleType type, const std::string& regNo)
+    // empty ref if the registration number is longer than PlateNumber::MAX_LENGTH
+    static VehicleRef createVehicle(VehicleType type, std::string_view regNo)
     {
+        if(regNo.size() > PlateNumber::MAX_LENGTH) return VehicleRef{};
+
+        uint32_t index;
         switch (type)
         {
         case VehicleType::Car:
-            return std::make_shared<Car>(regNo);
+            index = cars().create(regNo);
             break;
         case VehicleType::Motorcycle:
+            index = motorcycles().create(regNo);
             break;
         case VehicleType::Bus:
+            index = buses().create(regNo);
             break;
         case VehicleType::Truck:
+            index = trucks().create(regNo);
             break;
         default:
-            return nullptr;
+            return VehicleRef{};
+        }
+
+        return VehicleRef{(static_cast<VehicleHandle>(type) << 30) | (index + 1)};
+    }
+
+    // returns the vehicle's memory to its pool, O(1); every ref to it dangles afterwards
+    static void destroyVehicle(VehicleRef vehicle)
+    {
+        if(!vehicle) return;
+        uint32_t index = (vehicle.handle() & HANDLE_INDEX_MASK) - 1;
+        switch (vehicle.type())
+        {
+        case VehicleType::Car: cars().destroy(index); break;
+        case VehicleType::Motorcycle: motorcycles().destroy(index); break;
+        case VehicleType::Bus: buses().destroy(index); break;
+        case VehicleType::Truck: trucks().destroy(index); break;
         }
+    }
 
+    static Vehicle* resolve(VehicleHandle handle)
+    {
+        if(handle == NO_VEHICLE) return nullptr;
+        uint32_t index = (handle & HANDLE_INDEX_MASK) - 1;
+        switch (handle_type(handle))
+        {
+        case VehicleType::Car: return cars().get(index);
+        case VehicleType::Motorcycle: return motorcycles().get(index);
+        case VehicleType::Bus: return buses().get(index);
+        case VehicleType::Truck: return trucks().get(index);
+        }
         return nullptr;
     }
+
+private:
+    static SlabPool<Car>& cars() { static SlabPool<Car> pool; return pool; }
+    static SlabPool<Motorcycle>& motorcycles() { static SlabPool<Motorcycle> pool; return pool; }
+    static SlabPool<Truck>& trucks() { static SlabPool<Truck> pool; return pool; }
+    static SlabPool<Bus>& buses() { static SlabPool<Bus> pool; return pool; }
 };
+
+inline Vehicle* VehicleRef::get() const
+{
+    return VehicleFactory::resolve(handle_);
+}
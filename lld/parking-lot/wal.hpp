@@ -0,0 +1,615 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "vehicle.hpp"
+#include "slot_pool.hpp"
+
+// One park or unpark, as it goes to disk
+struct WalRecord
+{
+    static constexpr uint8_t PARK = 1;
+    static constexpr uint8_t UNPARK = 2;
+    static constexpr uint8_t TICKETED = 1;      // flags: parked through EnterVehicle, its plate is in the index
+
+    uint64_t lsn;               // log sequence number, from 1, consecutive
+    uint64_t slot;
+    uint64_t ticket;            // PARK with TICKETED only: the ticket's id
+    int64_t entry;              // PARK with TICKETED only: entry time, seconds since the Unix epoch
+    PlateNumber plate;          // PARK only
+    uint8_t op;
+    uint8_t type;               // VehicleType, PARK only
+    uint8_t flags;
+    uint8_t reserved;
+    uint32_t checksum;          // wal_checksum of every byte before it
+
+    // ticket 0: parked without a ticket (ParkVehcile)
+    static WalRecord park(size_t slot, VehicleType type, std::string_view plate, uint64_t ticket, int64_t entry)
+    {
+        WalRecord r{};
+        r.slot = slot;
+        r.plate = PlateNumber{plate};
+        r.op = PARK;
+        r.type = static_cast<uint8_t>(type);
+        r.flags = ticket != 0 ? TICKETED : 0;
+        r.ticket = ticket;
+        r.entry = ticket != 0 ? entry : 0;
+        return r;
+    }
+
+    static WalRecord unpark(size_t slot)
+    {
+        WalRecord r{};
+        r.slot = slot;
+        r.op = UNPARK;
+        return r;
+    }
+};
+
+static_assert(sizeof(WalRecord) == 56, "WalRecord must have no padding, the checksum covers its raw bytes");
+
+// 64-bit multiply-xor hash, 8 bytes per step (same mix as the city snapshots)
+inline uint64_t wal_checksum(uint64_t h, const char *data, size_t size)
+{
+    auto mix = [&h](uint64_t word) {
+        h = (h ^ word) * 0x100000001B3ull;
+        h ^= h >> 29;
+    };
+    size_t i = 0;
+    for(; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        mix(word);
+    }
+    uint64_t tail = 0;
+    if(size > i) std::memcpy(&tail, data + i, size - i);
+    mix(tail ^ size);
+    return h;
+}
+
+inline uint32_t record_checksum(const WalRecord &r)
+{
+    return static_cast<uint32_t>(wal_checksum(0xCBF29CE484222325ull, reinterpret_cast<const char*>(&r),
+                                              offsetof(WalRecord, checksum)));
+}
+
+// Which vehicle is in which slot, as of log sequence number lsn
+struct LotState
+{
+    struct Parked
+    {
+        size_t slot;
+        VehicleType type;
+        PlateNumber plate;
+        bool ticketed;
+        uint64_t ticket{0};             // ticketed only: id and entry time (Unix seconds) of its ticket
+        int64_t entry{0};
+    };
+
+    uint64_t lsn{0};
+    std::vector<Parked> vehicles;       // by slot ID
+    size_t anomalies{0};                // replayed parks into a taken slot / unparks of a free one, 0 if sane
+};
+
+// Bounded multi-producer single-consumer queue of WalRecords, lock-free
+/*
+    Vyukov's array queue: a producer claims position p with one CAS on the tail, fills cell p % capacity and
+    publishes it by setting the cell's sequence to p + 1; the consumer takes cells in position order as
+    long as they are published. The claimed position is the record's LSN - 1, so LSNs follow claim order,
+    and a record claimed before another is replayed before it. A full queue makes producers wait, records
+    are never dropped.
+*/
+class WalQueue
+{
+    struct Cell
+    {
+        std::atomic<uint64_t> seq;
+        WalRecord record;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_;
+    alignas(64) std::atomic<uint64_t> tail_;
+    alignas(64) uint64_t head_;                         // consumer only
+
+public:
+    // capacity must be a power of two; positions start at first (LSN first + 1)
+    WalQueue(size_t capacity, uint64_t first)
+        : cells_(new Cell[capacity]), mask_(capacity - 1), tail_(first), head_(first)
+    {
+        for(uint64_t p = first; p < first + capacity; ++p) cells_[p & mask_].seq.store(p, std::memory_order_relaxed);
+    }
+
+    // returns the record's LSN
+    uint64_t push(WalRecord record)
+    {
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        for(;;) {
+            Cell &cell = cells_[pos & mask_];
+            uint64_t seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<int64_t>(seq - pos);
+            if(diff == 0) {
+                if(tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if(diff < 0) {
+                std::this_thread::yield();          // full: the writer is behind
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+            else pos = tail_.load(std::memory_order_relaxed);
+        }
+
+        Cell &cell = cells_[pos & mask_];
+        record.lsn = pos + 1;
+        record.checksum = record_checksum(record);
+        cell.record = record;
+        cell.seq.store(pos + 1, std::memory_order_release);
+        return pos + 1;
+    }
+
+    // consumer: appends up to max published records in order, returns how many
+    size_t pop(std::vector<WalRecord> &out, size_t max)
+    {
+        size_t n = 0;
+        for(; n < max; ++n, ++head_) {
+            Cell &cell = cells_[head_ & mask_];
+            if(cell.seq.load(std::memory_order_acquire) != head_ + 1) break;
+            out.push_back(cell.record);
+            cell.seq.store(head_ + mask_ + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // LSN the next push will get
+    uint64_t next_lsn() const { return tail_.load(std::memory_order_relaxed) + 1; }
+};
+
+// WriteAheadLog tuning
+struct WalOptions
+{
+    size_t snapshot_every = 1 << 20;            // records between snapshots
+    bool keep_segments = false;                 // keep segments a snapshot has made redundant
+    size_t queue_capacity = 1 << 16;            // power of two
+    size_t max_batch = 1 << 14;                 // records per write + fdatasync
+    std::chrono::microseconds idle{200};        // writer poll interval when the queue is empty
+};
+
+// Write-ahead log of a ParkingLot, with group commit and occupancy snapshots
+/*
+    Gates append a WalRecord per park/unpark into a WalQueue and go on; a dedicated writer thread drains
+    whatever has queued up, writes it with one write() and makes it durable with one fdatasync() (group
+    commit: the batch is everything that arrived during the previous sync), then advances durable_lsn().
+    Gates never wait on the disk; a caller that needs its record on disk before it answers calls sync(lsn).
+
+    Directory layout:
+        wal-<first lsn>.log     segments: SegmentHeader, then WalRecords back to back
+        snapshot.bin            SnapshotHeader, occupancy bitmap (one bit per slot ID), then one
+                                SnapshotEntry per occupied slot in slot order
+
+    A ticketed park carries its ticket's id and entry time, in Unix seconds since every process's
+    TicketStore has its own epoch, so a restored lot bills a stay from when the vehicle really came in.
+
+    The writer applies every record it writes to a shadow copy of the lot's occupancy, so a snapshot is an
+    exact picture as of one LSN, taken without looking at the live lot. Every snapshot_every records it is
+    written to snapshot.tmp, synced and renamed over snapshot.bin; then a new segment is started and, unless
+    keep_segments, the older ones are deleted.
+
+    recover() loads the snapshot (if it is intact) and replays every following record of the segments in
+    LSN order, stopping at the first torn or corrupt record: the result is the lot as of the last record that
+    fully reached the file. A new WriteAheadLog constructed from that state continues at the next LSN in a new
+    segment, so the garbage after a torn tail is never appended to.
+*/
+class WriteAheadLog
+{
+public:
+
+    struct SegmentHeader
+    {
+        static constexpr char MAGIC[8] = {'P', 'L', 'O', 'T', 'W', 'A', 'L', '1'};
+        static constexpr uint32_t VERSION = 2;
+
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+    };
+
+    struct SnapshotHeader
+    {
+        static constexpr char MAGIC[8] = {'P', 'L', 'O', 'T', 'S', 'N', 'A', 'P'};
+        static constexpr uint32_t VERSION = 2;
+        static constexpr uint32_t ENDIAN_MARK = 0x01020304;
+
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint64_t lsn;
+        uint64_t slot_count;        // bitmap covers slot IDs 0 .. slot_count - 1
+        uint64_t occupied;
+        uint64_t checksum;          // wal_checksum of the bitmap followed by the entries
+    };
+
+    struct SnapshotEntry
+    {
+        uint64_t ticket;
+        int64_t entry;
+        PlateNumber plate;
+        uint8_t type;
+        uint8_t flags;
+        uint8_t reserved[6];        // zero, the checksum covers the raw bytes
+    };
+    static_assert(sizeof(SnapshotEntry) == 40, "SnapshotEntry must have no padding");
+
+private:
+    struct ShadowSlot
+    {
+        PlateNumber plate;
+        uint8_t type{0};
+        uint8_t flags{0};
+        bool occupied{false};
+        uint64_t ticket{0};
+        int64_t entry{0};
+    };
+
+    std::string dir_;
+    WalOptions options_;
+    WalQueue queue_;
+
+    // writer thread only
+    std::vector<ShadowSlot> shadow_;
+    int segment_fd_{-1};
+    size_t since_snapshot_{0};
+
+    alignas(64) std::atomic<uint64_t> durable_lsn_;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> failed_{false};
+    std::mutex sync_mtx_;
+    std::condition_variable synced_;
+    std::thread writer_;
+
+    static std::string segment_name(uint64_t first_lsn)
+    {
+        char name[40];
+        std::snprintf(name, sizeof(name), "wal-%020llu.log", static_cast<unsigned long long>(first_lsn));
+        return name;
+    }
+
+    static bool write_all(int fd, const void *data, size_t size)
+    {
+        auto p = static_cast<const char*>(data);
+        while(size > 0) {
+            ssize_t n = ::write(fd, p, size);
+            if(n < 0 && errno == EINTR) continue;
+            if(n <= 0) return false;
+            p += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    static bool sync_dir(const std::string &dir)
+    {
+        int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if(fd < 0) return false;
+        bool ok = ::fsync(fd) == 0;
+        ::close(fd);
+        return ok;
+    }
+
+    static std::optional<std::vector<char>> read_file(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if(fd < 0) return std::nullopt;
+        std::vector<char> file;
+        char buf[1 << 16];
+        for(ssize_t n; (n = ::read(fd, buf, sizeof(buf))) > 0;) file.insert(file.end(), buf, buf + n);
+        ::close(fd);
+        return file;
+    }
+
+    // sorted by first LSN (the zero padded names sort that way)
+    static std::vector<std::filesystem::path> segments(const std::string &dir)
+    {
+        std::vector<std::filesystem::path> found;
+        std::error_code ec;
+        for(auto &entry : std::filesystem::directory_iterator(dir, ec)) {
+            auto name = entry.path().filename().string();
+            if(name.size() == 28 && name.starts_with("wal-") && name.ends_with(".log")) found.push_back(entry.path());
+        }
+        std::sort(found.begin(), found.end());
+        return found;
+    }
+
+    static uint64_t first_lsn(const std::filesystem::path &segment)
+    {
+        return std::stoull(segment.filename().string().substr(4, 20));
+    }
+
+    static void apply(std::vector<ShadowSlot> &slots, const WalRecord &r, size_t &anomalies)
+    {
+        if(r.slot >= slots.size()) slots.resize(std::max<size_t>(r.slot + 1, slots.size() * 2));
+        ShadowSlot &slot = slots[r.slot];
+        if(r.op == WalRecord::PARK) {
+            if(slot.occupied) ++anomalies;
+            slot = ShadowSlot{r.plate, r.type, r.flags, true, r.ticket, r.entry};
+        }
+        else {
+            if(!slot.occupied) ++anomalies;
+            slot.occupied = false;
+        }
+    }
+
+    static bool valid(const WalRecord &r)
+    {
+        return r.checksum == record_checksum(r) &&
+               ((r.op == WalRecord::PARK && r.type < VEHICLE_TYPE_COUNT) || r.op == WalRecord::UNPARK);
+    }
+
+    bool open_segment(uint64_t first_lsn)
+    {
+        if(segment_fd_ >= 0) ::close(segment_fd_);
+        std::string path = dir_ + "/" + segment_name(first_lsn);
+        segment_fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if(segment_fd_ < 0) return false;
+
+        SegmentHeader header{};
+        std::memcpy(header.magic, SegmentHeader::MAGIC, sizeof(header.magic));
+        header.version = SegmentHeader::VERSION;
+        header.record_size = sizeof(WalRecord);
+        return write_all(segment_fd_, &header, sizeof(header)) && ::fdatasync(segment_fd_) == 0 && sync_dir(dir_);
+    }
+
+    // snapshot as of lsn (every record up to it is applied to shadow_ and durable), then a fresh segment
+    bool snapshot(uint64_t lsn)
+    {
+        std::vector<uint64_t> bitmap((shadow_.size() + 63) / 64);
+        std::vector<SnapshotEntry> entries;
+        for(size_t s = 0; s < shadow_.size(); ++s) {
+            if(!shadow_[s].occupied) continue;
+            bitmap[s / 64] |= uint64_t{1} << (s % 64);
+            SnapshotEntry entry{};
+            entry.ticket = shadow_[s].ticket;
+            entry.entry = shadow_[s].entry;
+            entry.plate = shadow_[s].plate;
+            entry.type = shadow_[s].type;
+            entry.flags = shadow_[s].flags;
+            entries.push_back(entry);
+        }
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SnapshotHeader::MAGIC, sizeof(header.magic));
+        header.version = SnapshotHeader::VERSION;
+        header.byte_order = SnapshotHeader::ENDIAN_MARK;
+        header.lsn = lsn;
+        header.slot_count = shadow_.size();
+        header.occupied = entries.size();
+        header.checksum = wal_checksum(
+            wal_checksum(0xCBF29CE484222325ull, reinterpret_cast<const char*>(bitmap.data()),
+                         bitmap.size() * sizeof(uint64_t)),
+            reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SnapshotEntry));
+
+        // temporary + rename: a crash leaves either the old snapshot or the new one
+        std::string tmp = dir_ + "/snapshot.tmp";
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0) return false;
+        bool ok = write_all(fd, &header, sizeof(header)) &&
+                  write_all(fd, bitmap.data(), bitmap.size() * sizeof(uint64_t)) &&
+                  write_all(fd, entries.data(), entries.size() * sizeof(SnapshotEntry)) &&
+                  ::fdatasync(fd) == 0;
+        ::close(fd);
+        if(!ok || std::rename(tmp.c_str(), (dir_ + "/snapshot.bin").c_str()) != 0 || !sync_dir(dir_)) return false;
+
+        if(!open_segment(lsn + 1)) return false;
+        if(!options_.keep_segments) {
+            std::string current = segment_name(lsn + 1);
+            for(auto &path : segments(dir_)) {
+                std::error_code ec;
+                if(path.filename() != current) std::filesystem::remove(path, ec);
+            }
+        }
+        since_snapshot_ = 0;
+        return true;
+    }
+
+    void run()
+    {
+        std::vector<WalRecord> batch;
+        batch.reserve(options_.max_batch);
+        for(;;) {
+            bool stopping = stop_.load(std::memory_order_acquire);
+            batch.clear();
+            if(queue_.pop(batch, options_.max_batch) == 0) {
+                if(stopping) return;
+                std::this_thread::sleep_for(options_.idle);
+                continue;
+            }
+
+            if(failed_.load(std::memory_order_relaxed)) continue;       // keep draining so gates never block
+            if(!write_all(segment_fd_, batch.data(), batch.size() * sizeof(WalRecord)) ||
+               ::fdatasync(segment_fd_) != 0) {
+                failed_.store(true, std::memory_order_relaxed);
+                synced_.notify_all();
+                continue;
+            }
+
+            size_t anomalies = 0;
+            for(auto &r : batch) apply(shadow_, r, anomalies);
+            uint64_t lsn = batch.back().lsn;
+            {
+                std::scoped_lock<std::mutex> lock{sync_mtx_};
+                durable_lsn_.store(lsn, std::memory_order_release);
+            }
+            synced_.notify_all();
+
+            since_snapshot_ += batch.size();
+            if(since_snapshot_ >= options_.snapshot_every && !snapshot(lsn)) {
+                failed_.store(true, std::memory_order_relaxed);
+                synced_.notify_all();
+            }
+        }
+    }
+
+public:
+    // continues the log in dir after state (empty for a new lot); throws std::runtime_error if dir is unusable
+    explicit WriteAheadLog(std::string dir, const LotState &state = {}, WalOptions options = {})
+        : dir_(std::move(dir)), options_(options), queue_(options.queue_capacity, state.lsn),
+          durable_lsn_(state.lsn)
+    {
+        if(!std::has_single_bit(options_.queue_capacity) || options_.max_batch == 0) {
+            throw std::invalid_argument("WriteAheadLog: queue_capacity must be a power of two");
+        }
+        std::error_code ec;
+        std::filesystem::create_directories(dir_, ec);
+        for(auto &v : state.vehicles) {
+            if(v.slot >= shadow_.size()) shadow_.resize(std::max<size_t>(v.slot + 1, shadow_.size() * 2));
+            shadow_[v.slot] = ShadowSlot{v.plate, static_cast<uint8_t>(v.type),
+                                         static_cast<uint8_t>(v.ticketed ? WalRecord::TICKETED : 0), true,
+                                         v.ticket, v.entry};
+        }
+        if(!open_segment(state.lsn + 1)) throw std::runtime_error("WriteAheadLog: cannot create a segment in " + dir_);
+        writer_ = std::thread{[this] { run(); }};
+    }
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // everything appended so far is written and synced before the writer stops
+    ~WriteAheadLog()
+    {
+        stop_.store(true, std::memory_order_release);
+        writer_.join();
+        if(segment_fd_ >= 0) ::close(segment_fd_);
+    }
+
+    // queues the record, returns its LSN; does not wait for the disk
+    uint64_t append(const WalRecord &record)
+    {
+        return queue_.push(record);
+    }
+
+    // blocks until lsn is durable; false if the log has failed (disk error) and never will be
+    bool sync(uint64_t lsn)
+    {
+        std::unique_lock<std::mutex> lock{sync_mtx_};
+        synced_.wait(lock, [&] {
+            return durable_lsn_.load(std::memory_order_relaxed) >= lsn || failed_.load(std::memory_order_relaxed);
+        });
+        return durable_lsn_.load(std::memory_order_relaxed) >= lsn;
+    }
+
+    uint64_t durable_lsn() const { return durable_lsn_.load(std::memory_order_acquire); }
+    uint64_t appended_lsn() const { return queue_.next_lsn() - 1; }
+    bool failed() const { return failed_.load(std::memory_order_relaxed); }
+
+    // the lot as of the last intact record in dir; nullopt if the log has a hole (records lost before it)
+    static std::optional<LotState> recover(const std::string &dir, bool use_snapshot = true)
+    {
+        std::vector<ShadowSlot> slots;
+        LotState state;
+
+        if(use_snapshot) {
+            if(auto snap = load_snapshot(dir + "/snapshot.bin", slots)) state.lsn = *snap;
+            else slots.clear();
+        }
+
+        auto found = segments(dir);
+        for(size_t i = 0; i < found.size(); ++i) {
+            // a segment whose successor starts at or before the next LSN has nothing left to replay
+            if(i + 1 < found.size() && first_lsn(found[i + 1]) <= state.lsn + 1) continue;
+            auto file = read_file(found[i].string());
+            SegmentHeader header;
+            if(!file || file->size() < sizeof(header)) continue;
+            std::memcpy(&header, file->data(), sizeof(header));
+            if(std::memcmp(header.magic, SegmentHeader::MAGIC, sizeof(header.magic)) != 0 ||
+               header.version != SegmentHeader::VERSION || header.record_size != sizeof(WalRecord)) {
+                continue;
+            }
+
+            // records up to the current LSN are covered already, a gap means lost records
+            for(size_t off = sizeof(header); file->size() - off >= sizeof(WalRecord); off += sizeof(WalRecord)) {
+                WalRecord r;
+                std::memcpy(&r, file->data() + off, sizeof(r));
+                if(!valid(r)) break;                    // torn or corrupt: the rest of this segment never made it
+                if(r.lsn <= state.lsn) continue;
+                if(r.lsn != state.lsn + 1) return std::nullopt;
+                apply(slots, r, state.anomalies);
+                state.lsn = r.lsn;
+            }
+        }
+
+        for(size_t s = 0; s < slots.size(); ++s) {
+            if(!slots[s].occupied) continue;
+            state.vehicles.push_back(LotState::Parked{s, static_cast<VehicleType>(slots[s].type), slots[s].plate,
+                                                      (slots[s].flags & WalRecord::TICKETED) != 0, slots[s].ticket,
+                                                      slots[s].entry});
+        }
+        return state;
+    }
+
+private:
+    // fills slots, returns the snapshot's LSN; nullopt if missing or not intact
+    static std::optional<uint64_t> load_snapshot(const std::string &path, std::vector<ShadowSlot> &slots)
+    {
+        auto read = read_file(path);
+        if(!read) return std::nullopt;
+        const std::vector<char> &file = *read;
+
+        SnapshotHeader header;
+        if(file.size() < sizeof(header)) return std::nullopt;
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        // checked as "count <= (size - offset) / unit" so nothing can wrap
+        const uint64_t body = file.size() - sizeof(header);
+        if(std::memcmp(header.magic, SnapshotHeader::MAGIC, sizeof(header.magic)) != 0 ||
+           header.version != SnapshotHeader::VERSION || header.byte_order != SnapshotHeader::ENDIAN_MARK ||
+           header.slot_count > body * 8 || header.occupied > header.slot_count) {
+            return std::nullopt;
+        }
+        const uint64_t words = (header.slot_count + 63) / 64;
+        if(header.occupied != (body - words * sizeof(uint64_t)) / sizeof(SnapshotEntry) ||
+           body != words * sizeof(uint64_t) + header.occupied * sizeof(SnapshotEntry)) {
+            return std::nullopt;
+        }
+
+        const char *bitmap = file.data() + sizeof(header);
+        const char *entries = bitmap + words * sizeof(uint64_t);
+        uint64_t checksum = wal_checksum(wal_checksum(0xCBF29CE484222325ull, bitmap, words * sizeof(uint64_t)),
+                                         entries, header.occupied * sizeof(SnapshotEntry));
+        if(checksum != header.checksum) return std::nullopt;
+
+        slots.assign(header.slot_count, ShadowSlot{});
+        uint64_t e = 0;
+        for(uint64_t w = 0; w < words; ++w) {
+            uint64_t bits;
+            std::memcpy(&bits, bitmap + w * sizeof(uint64_t), sizeof(bits));
+            for(; bits; bits &= bits - 1) {
+                size_t s = w * 64 + std::countr_zero(bits);
+                if(s >= header.slot_count || e == header.occupied) return std::nullopt;
+                SnapshotEntry entry;
+                std::memcpy(&entry, entries + e++ * sizeof(SnapshotEntry), sizeof(entry));
+                if(entry.type >= VEHICLE_TYPE_COUNT) return std::nullopt;
+                slots[s] = ShadowSlot{entry.plate, entry.type, entry.flags, true, entry.ticket, entry.entry};
+            }
+        }
+        if(e != header.occupied) return std::nullopt;
+        return header.lsn;
+    }
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "vehicle.hpp"
+#include "slot_pool.hpp"
+
+// Where a zone (or a gate) is: floor number and walking distance along the floor
+struct Position
+{
+    uint32_t floor{0};
+    uint32_t offset{0};
+};
+
+inline uint64_t distance(const Position &a, const Position &b)
+{
+    // changing floors costs more than walking along one
+    static constexpr uint64_t FLOOR_COST = 100;
+    auto diff = [](uint32_t x, uint32_t y) -> uint64_t { return x > y ? x - y : y - x; };
+    return diff(a.floor, b.floor) * FLOOR_COST + diff(a.offset, b.offset);
+}
+
+// slots per size class of one zone, plus where it is
+struct ZoneConfig
+{
+    std::array<size_t, SLOT_SIZE_COUNT> slots{};
+    uint32_t offset{0};
+};
+
+// Zone: the unit of sharding
+/*
+    A zone owns one SlotPool per size class, each with its own lock-free FreeBitmap, so gates parking in
+    different zones never touch the same memory. Slot IDs
+    of a zone are the consecutive range given at construction, pool after pool, which lets the lot map an ID
+    back to its zone with a binary search over zone ranges.
+*/
+class Zone
+{
+    Position position_;
+    std::array<std::unique_ptr<SlotPool>, SLOT_SIZE_COUNT> pools_;
+    size_t first_id_;
+    size_t slot_count_{0};
+
+public:
+    // slot IDs first_id .. first_id + total slots of config - 1
+    Zone(uint32_t floor, const ZoneConfig &config, size_t first_id) : position_{floor, config.offset}, first_id_(first_id)
+    {
+        for(size_t c = 0; c < SLOT_SIZE_COUNT; ++c) {
+            pools_[c] = std::make_unique<SlotPool>(static_cast<SlotSize>(c), config.slots[c], first_id_ + slot_count_);
+            slot_count_ += config.slots[c];
+        }
+    }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+    // parks in the pool of exactly this size class, returns the slot ID; see SlotPool::park for on_claimed,
+    // which gets the slot ID here
+    template<typename OnClaimed>
+    std::optional<size_t> park(VehicleRef vehicle, SlotSize size, size_t hint, OnClaimed &&on_claimed)
+    {
+        SlotPool &pool = *pools_[static_cast<size_t>(size)];
+        if(pool.size() == 0) return std::nullopt;
+        auto idx = pool.park(vehicle, hint % pool.size(), [&](size_t i) { on_claimed(pool.slot_id(i)); });
+        if(!idx) return std::nullopt;
+        return pool.slot_id(*idx);
+    }
+
+    std::optional<size_t> park(VehicleRef vehicle, SlotSize size, size_t hint)
+    {
+        return park(vehicle, size, hint, [](size_t) {});
+    }
+
+    // slotID must be in [first_id(), first_id() + slot_count()); see SlotPool::unpark for on_taken
+    template<typename OnTaken>
+    VehicleRef unpark(size_t slotID, OnTaken &&on_taken)
+    {
+        for(auto &pool : pools_) {
+            if(pool->contains(slotID)) return pool->unpark(slotID - pool->first_id(), on_taken);
+        }
+        return VehicleRef{};
+    }
+
+    VehicleRef unpark(size_t slotID)
+    {
+        return unpark(slotID, [](VehicleRef) {});
+    }
+
+    // puts the vehicle into this very slot (recovery), false if it is taken or not in this zone
+    bool place(size_t slotID, VehicleRef vehicle)
+    {
+        for(auto &pool : pools_) {
+            if(pool->contains(slotID)) return pool->place(slotID - pool->first_id(), vehicle);
+        }
+        return false;
+    }
+
+    // SlotPool::hold / fill / unhold by slot ID; hold is false if the slot is taken or not in this zone
+    bool hold(size_t slotID)
+    {
+        SlotPool *pool = pool_of(slotID);
+        return pool && pool->hold(slotID - pool->first_id());
+    }
+
+    void fill(size_t slotID, VehicleRef vehicle)
+    {
+        if(SlotPool *pool = pool_of(slotID)) pool->fill(slotID - pool->first_id(), vehicle);
+    }
+
+    void unhold(size_t slotID)
+    {
+        if(SlotPool *pool = pool_of(slotID)) pool->unhold(slotID - pool->first_id());
+    }
+
+    void count_by_type(std::array<size_t, VEHICLE_TYPE_COUNT> &counts) const
+    {
+        for(auto &pool : pools_) pool->count_by_type(counts);
+    }
+
+    const SlotPool& pool(SlotSize size) const { return *pools_[static_cast<size_t>(size)]; }
+
+    SlotPool* pool_of(size_t slotID)
+    {
+        for(auto &pool : pools_) {
+            if(pool->contains(slotID)) return pool.get();
+        }
+        return nullptr;
+    }
+    const Position& position() const { return position_; }
+    size_t first_id() const { return first_id_; }
+    size_t slot_count() const { return slot_count_; }
+    size_t available(SlotSize size) const { return pool(size).available(); }
+};
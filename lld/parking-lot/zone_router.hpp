@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "zone.hpp"
+
+// Strategy: in which order to try the zones for an arriving vehicle
+class ZoneRouter
+{
+public:
+    virtual ~ZoneRouter() = default;
+
+    // fills order with every zone of zones, best candidate first
+    virtual void route(std::span<Zone* const> zones, SlotSize size, const Position &gate,
+                       std::vector<Zone*> &order) const = 0;
+
+    // true if the order only depends on the gate and the set of zones, the lot may then cache it
+    virtual bool cacheable() const { return false; }
+
+    // true if the order is always zones itself rotated to start at first(): the lot then walks zones in place
+    // instead of asking route() for an order vector on every park
+    virtual bool rotates() const { return false; }
+
+    // index in zones of the first zone to try, only used when rotates()
+    virtual size_t first(std::span<Zone* const>, SlotSize, const Position &) const { return 0; }
+};
+
+// closest zone to the entry gate first: short walks, and gates far apart work on different zones
+class NearestToGateRouter : public ZoneRouter
+{
+public:
+    void route(std::span<Zone* const> zones, SlotSize, const Position &gate, std::vector<Zone*> &order) const override
+    {
+        order.assign(zones.begin(), zones.end());
+        std::stable_sort(order.begin(), order.end(), [&](const Zone *a, const Zone *b) {
+            return distance(a->position(), gate) < distance(b->position(), gate);
+        });
+    }
+
+    bool cacheable() const override { return true; }
+};
+
+// spreads load (and contention) evenly
+/*
+    Power of two choices: of two zones picked at random the one with more free slots of the vehicle's class
+    goes first, the others follow in directory order. Nearly as even as always taking the emptiest zone, but
+    reads two counters per park instead of every zone's. The order is a rotation of the directory, so the lot
+    only asks for the first zone: a park costs two counter reads, not an O(zones) order.
+*/
+class LeastLoadedRouter : public ZoneRouter
+{
+public:
+    void route(std::span<Zone* const> zones, SlotSize size, const Position &gate, std::vector<Zone*> &order) const override
+    {
+        order.clear();
+        if(zones.empty()) return;
+        size_t start = first(zones, size, gate);
+        for(size_t i = 0; i < zones.size(); ++i) order.push_back(zones[(start + i) % zones.size()]);
+    }
+
+    bool rotates() const override { return true; }
+
+    size_t first(std::span<Zone* const> zones, SlotSize size, const Position &) const override
+    {
+        if(zones.empty()) return 0;
+
+        thread_local uint64_t state = reinterpret_cast<uintptr_t>(&state) | 1;
+        auto next = [] {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        };
+        size_t a = next() % zones.size();
+        size_t b = next() % zones.size();
+        return zones[a]->available(size) >= zones[b]->available(size) ? a : b;
+    }
+};
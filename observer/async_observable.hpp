@@ -0,0 +1,324 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "field_id.hpp"
+#include "safe_observable.hpp"
+
+// What a publisher does when the notification ring is full
+enum class BackPressure
+{
+    block,          // wait for the dispatcher to make room
+    drop_oldest,    // evict the oldest queued notification
+    coalesce        // park (source, field) in an overflow set, delivered once after the ring drains
+};
+
+/*
+    Bounded multi-producer ring (Vyukov style): every cell carries a sequence number, producers claim a
+    position with a CAS on the tail and publish the cell by bumping its sequence. Popping is done by the
+    dispatcher, and by publishers evicting under drop_oldest, so the head side is CAS based as well.
+*/
+template<typename E>
+class NotificationRing
+{
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        E event;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    const size_t mask_;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<size_t> head_{0};
+
+public:
+    // capacity is rounded up to a power of two
+    explicit NotificationRing(size_t capacity)
+        : cells_(nullptr), mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1)
+    {
+        cells_.reset(new Cell[mask_ + 1]);
+        for(size_t i = 0; i <= mask_; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    bool try_push(const E &event)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for(;;) {
+            Cell &cell = cells_[pos & mask_];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if(diff == 0) {
+                if(tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.event = event;
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff < 0) return false;         // full
+            else pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool try_pop(E &event)
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for(;;) {
+            Cell &cell = cells_[pos & mask_];
+            size_t seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if(diff == 0) {
+                if(head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    event = cell.event;
+                    cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff < 0) return false;         // empty
+            else pos = head_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // every claimed cell has been popped; try_pop can fail on a non-empty ring while a producer is mid push
+    bool empty() const
+    {
+        return head_.load() == tail_.load();
+    }
+};
+
+// CRTP, asynchronous delivery on top of ThreadSafeObservable
+/*
+    notify only enqueues (source, field) and returns, so slow observers (console, network, ...) are off the
+    publisher's critical path. A dispatcher thread drains the ring in batches, drops repeated (source, field)
+    pairs inside a batch (observers read the current value from source anyway) and delivers the rest through
+    the regular ThreadSafeObservable subscriber list.
+
+    source objects must outlive delivery. A class deriving from AsyncObservable<T> (so it is its own source)
+    must call quiesce() at the top of its own destructor: by the time ~AsyncObservable runs the derived part
+    is already destroyed, so the base destructor only stops the dispatcher and drops whatever is still queued.
+
+    Bookkeeping: a publisher counts its notification in `enqueued` before it looks at `stopping`, and the
+    dispatcher only exits once `stopping` is set and every counted notification is retired, so a notification
+    that got past the check is always delivered. Ring events are retired in ring order; the overflow set is
+    only drained once the ring is empty, and a notification folded into an overflow entry is retired with it.
+*/
+template<typename T>
+struct AsyncObservable : ThreadSafeObservable<T>
+{
+private:
+    struct Event
+    {
+        T *source{nullptr};
+        FieldId field{""};
+
+        bool operator==(const Event &other) const { return source == other.source && field == other.field; }
+    };
+
+    struct EventHash
+    {
+        size_t operator()(const Event &e) const
+        {
+            return std::hash<T*>{}(e.source) ^ (static_cast<size_t>(e.field.id) * 0x9E3779B97F4A7C15ull);
+        }
+    };
+
+    static constexpr size_t MAX_BATCH = 256;
+
+    NotificationRing<Event> ring;
+    BackPressure policy;
+
+    // overflow set for BackPressure::coalesce, only touched once the ring is full: event -> notifications folded into it
+    std::mutex overflow_mtx;
+    std::unordered_map<Event, size_t, EventHash> overflow;
+    std::atomic<size_t> overflowed{0};      // notifications in the overflow set or in a batch taken from it
+    std::atomic<size_t> drains_started{0};
+    std::atomic<size_t> drains_done{0};
+
+    // wake-up / flush bookkeeping
+    std::mutex mtx;
+    std::condition_variable work_cv;        // dispatcher waits for events
+    std::condition_variable space_cv;       // blocked publishers and flush() wait here
+    std::atomic<size_t> enqueued{0};
+    std::atomic<size_t> retired{0};         // delivered, coalesced away or dropped
+    std::atomic<size_t> dropped{0};
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> discard{false};       // retire pending events without delivering them
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> stopped{false};       // dispatcher has exited, nothing will be retired any more
+
+    std::thread dispatcher;
+
+    void wake_dispatcher()
+    {
+        if(sleeping.load()) {
+            std::scoped_lock<std::mutex> lock{mtx};
+            work_cv.notify_one();
+        }
+    }
+
+    void retire(size_t n)
+    {
+        retired.fetch_add(n);
+        std::scoped_lock<std::mutex> lock{mtx};
+        space_cv.notify_all();
+    }
+
+    void run()
+    {
+        std::vector<Event> batch;
+        std::unordered_set<Event, EventHash> seen;
+        batch.reserve(MAX_BATCH);
+
+        for(;;) {
+            batch.clear();
+            seen.clear();
+            size_t taken = 0;
+
+            Event e;
+            while(taken < MAX_BATCH && ring.try_pop(e)) {
+                ++taken;
+                if(seen.insert(e).second) batch.push_back(e);
+            }
+            // overflow entries go out once nothing is left in the ring, so flush() can count ring events in order
+            bool drained = false;
+            if(taken == 0 && ring.empty()) {
+                std::scoped_lock<std::mutex> lock{overflow_mtx};
+                if(!overflow.empty()) {
+                    drained = true;
+                    drains_started.fetch_add(1);
+                    for(auto &[o, folded] : overflow) {
+                        taken += folded;
+                        if(seen.insert(o).second) batch.push_back(o);
+                    }
+                    overflow.clear();
+                }
+            }
+
+            if(taken == 0) {
+                std::unique_lock<std::mutex> lock{mtx};
+                sleeping.store(true);
+                // recheck after announcing we sleep, a publisher may have pushed in between
+                work_cv.wait(lock, [&] { return stopping || enqueued.load() != retired.load(); });
+                sleeping.store(false);
+                if(stopping && enqueued.load() == retired.load()) return;
+                continue;
+            }
+
+            if(!discard.load()) {
+                for(auto &ev : batch) ThreadSafeObservable<T>::notify(*ev.source, ev.field);
+            }
+            if(drained) {
+                overflowed.fetch_sub(taken);
+                drains_done.fetch_add(1);
+            }
+            retire(taken);
+        }
+    }
+
+public:
+    explicit AsyncObservable(size_t capacity = 4096, BackPressure policy = BackPressure::block)
+        : ring(capacity), policy(policy)
+    {
+        dispatcher = std::thread{[this] { run(); }};
+    }
+
+    AsyncObservable(const AsyncObservable&) = delete;
+    AsyncObservable& operator=(const AsyncObservable&) = delete;
+
+    // the derived object is gone here, anything still queued is dropped instead of delivered
+    ~AsyncObservable()
+    {
+        discard.store(true);
+        quiesce();
+    }
+
+    // Queues the notification, false once quiesce() has begun (the notification is not delivered then)
+    bool notify(T& source, FieldId field)
+    {
+        // counted before the check: the dispatcher cannot exit between the check and the push
+        enqueued.fetch_add(1);
+        if(stopping.load()) {
+            enqueued.fetch_sub(1);
+            return false;
+        }
+
+        Event e{&source, field};
+        while(!ring.try_push(e)) {
+            // a full ring keeps the dispatcher running even while stopping, it still owes this notification
+            if(policy == BackPressure::block) {
+                wake_dispatcher();
+                std::unique_lock<std::mutex> lock{mtx};
+                space_cv.wait_for(lock, std::chrono::milliseconds(1));
+            }
+            else if(policy == BackPressure::drop_oldest) {
+                Event oldest;
+                if(ring.try_pop(oldest)) {
+                    dropped.fetch_add(1);
+                    retire(1);
+                }
+            }
+            else {
+                {
+                    std::scoped_lock<std::mutex> lock{overflow_mtx};
+                    ++overflow[e];              // already pending: folded into it, retired with it
+                    overflowed.fetch_add(1);
+                }
+                wake_dispatcher();
+                return true;
+            }
+        }
+        wake_dispatcher();
+        return true;
+    }
+
+    /*
+        Waits until everything notified so far has been delivered (or dropped/coalesced), returns at once after
+        quiesce(). Ring events retire in order, so once `retired` reaches the count taken at the call every
+        earlier ring event is out; a notification parked in the overflow set is out once the overflow set has
+        been empty, or once a drain that started after the call is done.
+    */
+    void flush()
+    {
+        size_t target = enqueued.load();
+        size_t drain = overflowed.load() != 0 ? drains_started.load() + 1 : 0;
+        std::unique_lock<std::mutex> lock{mtx};
+        work_cv.notify_one();
+        space_cv.wait(lock, [&] {
+            bool parked = drain != 0 && overflowed.load() != 0 && drains_done.load() < drain;
+            return (retired.load() >= target && !parked) || stopped.load();
+        });
+    }
+
+    // Flushes and stops the dispatcher thread, later notify calls return false without enqueueing
+    void quiesce()
+    {
+        if(!dispatcher.joinable()) return;
+        {
+            std::scoped_lock<std::mutex> lock{mtx};
+            stopping = true;
+            work_cv.notify_one();
+        }
+        dispatcher.join();
+
+        std::scoped_lock<std::mutex> lock{mtx};
+        stopped = true;
+        space_cv.notify_all();
+    }
+
+    size_t dropped_count() const
+    {
+        return dropped.load();
+    }
+};
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "observer.hpp"
+#include "observable.hpp"
+
+/*
+    Fan-out benchmark: 10k observers spread over 50 fields, each observer only cares about its own field.
+    wildcard  -> everybody subscribes to everything and filters in field_changed (the old behaviour)
+    per_field -> subscribe(observer, field), notify only reaches the relevant bucket
+
+    build: g++ -std=c++20 -O2 bench_field_fanout.cc -o bench_field_fanout
+*/
+
+static constexpr size_t OBSERVERS = 10000;
+static constexpr size_t FIELDS = 50;
+static constexpr size_t EVENTS = 200000;
+
+struct Subject : Observable<Subject> {};
+
+struct FieldObserver : Observer<Subject>
+{
+    FieldId mine{""};
+    size_t calls{0};
+    size_t hits{0};
+
+    void field_changed(Subject &, FieldId field) override
+    {
+        ++calls;
+        if(field == mine) ++hits;
+    }
+};
+
+void run(const char *name, bool per_field)
+{
+    std::vector<std::string> names;
+    std::vector<FieldId> fields;
+    for(size_t f = 0; f < FIELDS; ++f) names.push_back("field_" + std::to_string(f));
+    for(auto &n : names) fields.emplace_back(n);
+
+    Subject subject;
+    std::vector<FieldObserver> observers(OBSERVERS);
+    for(size_t i = 0; i < OBSERVERS; ++i) {
+        observers[i].mine = fields[i % FIELDS];
+        if(per_field) subject.subscribe(observers[i], observers[i].mine);
+        else subject.subscribe(observers[i]);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for(size_t e = 0; e < EVENTS; ++e) subject.notify(subject, fields[e % FIELDS]);
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    size_t calls = 0, hits = 0;
+    for(auto &ob : observers) {
+        calls += ob.calls;
+        hits += ob.hits;
+    }
+
+    std::cout << name << "," << elapsed / EVENTS << ","
+              << static_cast<double>(calls) / EVENTS << "," << static_cast<double>(hits) / EVENTS << "\n";
+}
+
+int main()
+{
+    std::cout << "mode,ns_per_notify,callbacks_per_notify,relevant_callbacks_per_notify\n";
+    run("wildcard", false);
+    run("per_field", true);
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "observer.hpp"
+#include "observable.hpp"
+
+/*
+    Microbenchmark: string field names vs FieldId on every property change.
+    Global operator new is counted so the run proves notify + dispatch does not allocate.
+    Both a short field name ("age", as used in main.cc, fits the SSO buffer) and a long one are measured,
+    since the std::string baseline only allocates for the latter.
+
+    build: g++ -std=c++20 -O2 bench_field_id.cc -o bench_field_id
+*/
+
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void *p = std::malloc(size)) return p;
+    throw std::bad_alloc{};
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+static constexpr size_t OBSERVERS = 8;
+static constexpr size_t EVENTS = 1 << 22;
+
+// field names under test: the repo's real ones fit the std::string SSO buffer, the long one does not
+struct ShortName { static constexpr const char *value = "age"; };
+struct LongName { static constexpr const char *value = "age_in_years_since_birth"; };
+
+// ----------------------------------------------- old style, std::string field names ----------------------------------------------- //
+
+template<typename Name> struct LegacyPerson;
+
+template<typename Name>
+struct LegacyObserver
+{
+    virtual void field_changed(LegacyPerson<Name> &, const std::string &field_name) = 0;
+};
+
+template<typename Name>
+struct LegacyPerson
+{
+    std::vector<LegacyObserver<Name>*> observers;
+    int age_{0};
+
+    void notify(LegacyPerson &source, const std::string &field_name)
+    {
+        for(auto observer : observers) observer->field_changed(source, field_name);
+    }
+
+    void set_age(int age)
+    {
+        age_ = age;
+        notify(*this, Name::value);
+    }
+};
+
+template<typename Name>
+struct LegacyCounter : LegacyObserver<Name>
+{
+    size_t ages{0};
+    void field_changed(LegacyPerson<Name> &, const std::string &field_name) override
+    {
+        if(field_name == Name::value) ++ages;
+    }
+};
+
+// ----------------------------------------------------------- FieldId ----------------------------------------------------------- //
+
+template<typename Name>
+struct Person : Observable<Person<Name>>
+{
+    static constexpr FieldId age_field{Name::value};
+    int age_{0};
+
+    void set_age(int age)
+    {
+        age_ = age;
+        this->notify(*this, age_field);
+    }
+};
+
+template<typename Name>
+struct Counter : Observer<Person<Name>>
+{
+    size_t ages{0};
+    void field_changed(Person<Name> &, FieldId field) override
+    {
+        switch(field.id) {
+        case Person<Name>::age_field.id: ++ages; break;
+        }
+    }
+};
+
+template<typename P, typename O, typename Name>
+void run(const char *name)
+{
+    P person;
+    std::vector<O> observers(OBSERVERS);
+    for(auto &ob : observers) person.observers.push_back(&ob);
+
+    auto before = allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < EVENTS; ++i) person.set_age(static_cast<int>(i));
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    auto allocs = allocations.load() - before;
+
+    std::cout << name << "," << std::string_view{Name::value}.size() << "," << elapsed / EVENTS << ","
+              << static_cast<double>(allocs) / EVENTS << "," << observers.front().ages << "\n";
+}
+
+template<typename Name>
+void run_both()
+{
+    run<LegacyPerson<Name>, LegacyCounter<Name>, Name>("std::string");
+    run<Person<Name>, Counter<Name>, Name>("FieldId");
+}
+
+int main()
+{
+    std::cout << "variant,field_name_length,ns_per_notify,allocations_per_notify,events_seen\n";
+    run_both<ShortName>();
+    run_both<LongName>();
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "observer.hpp"
+#include "safe_observable.hpp"
+#include "cow_observable.hpp"
+
+/*
+    Multi-threaded notify benchmark: mutex ThreadSafeObservable vs copy-on-write CowObservable.
+    Every publisher thread hammers notify on the same subject, which is the hot Person::set_age case.
+
+    build: g++ -std=c++20 -O2 -pthread bench_notify.cc -o bench_notify
+*/
+
+static constexpr size_t OBSERVERS = 8;
+static constexpr size_t NOTIFIES_PER_RUN = 1 << 22;
+
+// CRTP subject parameterised on the observable flavour
+template<template<typename> class Base>
+struct Subject : Base<Subject<Base>> {};
+
+template<typename T>
+struct CountingObserver : Observer<T>
+{
+    std::atomic<size_t> calls{0};
+    void field_changed(T &source, FieldId field) override
+    {
+        asm volatile("" : : "r"(&source), "r"(field.id) : "memory");
+        calls.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+template<template<typename> class Base>
+double run(size_t threads)
+{
+    using subject_t = Subject<Base>;
+    subject_t subject;
+    std::vector<CountingObserver<subject_t>> observers(OBSERVERS);
+    for(auto &ob : observers) subject.subscribe(ob);
+
+    const FieldId field = "age"_field;
+    const size_t per_thread = NOTIFIES_PER_RUN / threads;
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    for(size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&] {
+            while(!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for(size_t i = 0; i < per_thread; ++i) subject.notify(subject, field);
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for(auto &th : pool) th.join();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return (per_thread * threads) / elapsed;
+}
+
+int main()
+{
+    std::cout << "threads,mutex_notifies_per_sec,cow_notifies_per_sec\n";
+    for(size_t threads : {1, 4, 16, 64}) {
+        auto mutex_rate = run<ThreadSafeObservable>(threads);
+        auto cow_rate = run<CowObservable>(threads);
+        std::cout << threads << "," << mutex_rate << "," << cow_rate << "\n";
+    }
+    return 0;
+}
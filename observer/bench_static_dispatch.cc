@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <boost/signals2.hpp>
+#include "observer.hpp"
+#include "observable.hpp"
+#include "static_observable.hpp"
+
+/*
+    Single-threaded dispatch cost with 4 observers:
+    Observable (virtual calls through a vector) vs StaticObservable (tuple, inlined) vs boost::signals2 (Observable2 in main.cc)
+
+    build: g++ -std=c++20 -O2 bench_static_dispatch.cc -o bench_static_dispatch
+*/
+
+static constexpr size_t EVENTS = 1 << 24;
+static const FieldId age_field = "age"_field;
+
+// same shape for every observer, so the only difference is how it gets called
+struct Tally
+{
+    size_t ages{0};
+    void count(FieldId field)
+    {
+        if(field == age_field) ++ages;
+    }
+};
+
+// ------------------------------------------------------------ Observable ------------------------------------------------------------ //
+
+struct DynamicPerson : Observable<DynamicPerson>
+{
+    int age_{0};
+    void set_age(int age) { age_ = age; notify(*this, age_field); }
+};
+
+struct DynamicTally : Observer<DynamicPerson>, Tally
+{
+    void field_changed(DynamicPerson&, FieldId field) override { count(field); }
+};
+
+// --------------------------------------------------------- StaticObservable --------------------------------------------------------- //
+
+struct StaticPerson;
+template<int> struct StaticTally : Tally
+{
+    void field_changed(StaticPerson&, FieldId field) { count(field); }
+};
+
+struct StaticPerson : StaticObservable<StaticPerson, StaticTally<0>, StaticTally<1>, StaticTally<2>, StaticTally<3>>
+{
+    int age_{0};
+    void set_age(int age) { age_ = age; notify(*this, age_field); }
+};
+
+// ---------------------------------------------------------- boost::signals2 ---------------------------------------------------------- //
+
+template <typename T> struct Observable2
+{
+    boost::signals2::signal<void(T&, FieldId)> field_changed;
+};
+
+struct SignalPerson : Observable2<SignalPerson>
+{
+    int age_{0};
+    void set_age(int age) { age_ = age; field_changed(*this, age_field); }
+};
+
+// ------------------------------------------------------------------------------------------------------------------------------------- //
+
+template<typename Person>
+double time_events(Person &person)
+{
+    auto start = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < EVENTS; ++i) {
+        person.set_age(static_cast<int>(i));
+        asm volatile("" : : "r"(&person) : "memory");     // keep the loop from being folded away
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / EVENTS;
+}
+
+int main()
+{
+    std::cout << "variant,ns_per_notify,events_seen\n";
+
+    DynamicPerson dynamic;
+    DynamicTally d[4];
+    for(auto &ob : d) dynamic.subscribe(ob);
+    std::cout << "Observable," << time_events(dynamic) << "," << d[3].ages << "\n";
+
+    StaticPerson stat;
+    std::cout << "StaticObservable," << time_events(stat) << "," << stat.observer<StaticTally<3>>().ages << "\n";
+
+    SignalPerson signal;
+    Tally s[4];
+    for(auto &t : s) signal.field_changed.connect([&t](SignalPerson&, FieldId field) { t.count(field); });
+    std::cout << "boost::signals2," << time_events(signal) << "," << s[3].ages << "\n";
+
+    return 0;
+}
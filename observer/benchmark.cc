@@ -0,0 +1,152 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <boost/signals2.hpp>
+#include "observer.hpp"
+#include "observable.hpp"
+#include "safe_observable.hpp"
+#include "cow_observable.hpp"
+
+/*
+    Benchmark suite for the observer implementations in this directory.
+
+    Every case is notify latency (time per iteration) and throughput (items_per_second) for
+        observers : 1 .. 100k subscribed observers
+        churn     : one subscribe + unsubscribe pair every `churn` notifies (0 = none)
+        threads   : publisher threads hammering the same subject (not for the plain Observable)
+
+    build: g++ -std=c++20 -O2 -pthread benchmark.cc -lbenchmark -o benchmark
+    run:   ./benchmark --benchmark_out=observer.csv --benchmark_out_format=csv
+*/
+
+static const FieldId age_field = "age"_field;
+
+template<template<typename> class Base>
+struct Subject : Base<Subject<Base>> {};
+
+template<typename T>
+struct NullObserver : Observer<T>
+{
+    void field_changed(T &source, FieldId field) override
+    {
+        benchmark::DoNotOptimize(&source);
+        benchmark::DoNotOptimize(field.id);
+    }
+};
+
+// Observable::unsubscribe logs to std::cout, keep that out of the CSV
+struct MuteCout
+{
+    std::ostringstream sink;
+    std::streambuf *saved;
+    MuteCout() : saved(std::cout.rdbuf(sink.rdbuf())) {}
+    ~MuteCout() { std::cout.rdbuf(saved); }
+};
+
+// ----------------------------------------------------- CRTP observables ----------------------------------------------------- //
+
+template<template<typename> class Base>
+struct CrtpCase
+{
+    using subject_t = Subject<Base>;
+    std::unique_ptr<subject_t> subject;
+    std::vector<NullObserver<subject_t>> observers;
+
+    static CrtpCase& get()
+    {
+        static CrtpCase instance;
+        return instance;
+    }
+};
+
+template<template<typename> class Base>
+static void BM_Notify(benchmark::State &state)
+{
+    auto &c = CrtpCase<Base>::get();
+    const auto observers = static_cast<size_t>(state.range(0));
+    const auto churn = static_cast<size_t>(state.range(1));
+
+    std::optional<MuteCout> mute;
+    if(state.thread_index() == 0) {
+        mute.emplace();
+        c.subject = std::make_unique<typename CrtpCase<Base>::subject_t>();
+        c.observers = std::vector<NullObserver<typename CrtpCase<Base>::subject_t>>(observers);
+        for(auto &ob : c.observers) c.subject->subscribe(ob);
+    }
+
+    NullObserver<typename CrtpCase<Base>::subject_t> churner;
+    size_t n = 0;
+    for(auto _ : state) {
+        c.subject->notify(*c.subject, age_field);
+        if(churn && ++n % churn == 0) {
+            c.subject->subscribe(churner);
+            c.subject->unsubscribe(churner);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if(state.thread_index() == 0) {
+        c.subject.reset();
+        c.observers.clear();
+    }
+}
+
+// ---------------------------------------------------- boost::signals2 (Observable2) ---------------------------------------------------- //
+
+template <typename T> struct Observable2
+{
+    boost::signals2::signal<void(T&, FieldId)> field_changed;
+};
+
+struct Person2 : Observable2<Person2> {};
+
+static std::unique_ptr<Person2> signal_subject;
+
+static void BM_Signals2(benchmark::State &state)
+{
+    const auto observers = static_cast<size_t>(state.range(0));
+    const auto churn = static_cast<size_t>(state.range(1));
+
+    if(state.thread_index() == 0) {
+        signal_subject = std::make_unique<Person2>();
+        for(size_t i = 0; i < observers; ++i) {
+            signal_subject->field_changed.connect([](Person2 &source, FieldId field) {
+                benchmark::DoNotOptimize(&source);
+                benchmark::DoNotOptimize(field.id);
+            });
+        }
+    }
+
+    size_t n = 0;
+    for(auto _ : state) {
+        signal_subject->field_changed(*signal_subject, age_field);
+        if(churn && ++n % churn == 0) {
+            signal_subject->field_changed.connect([](Person2&, FieldId) {}).disconnect();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if(state.thread_index() == 0) signal_subject.reset();
+}
+
+// ------------------------------------------------------------------------------------------------------------------------------------- //
+
+static void Cases(benchmark::internal::Benchmark *b)
+{
+    b->ArgNames({"observers", "churn"});
+    for(int64_t observers : {1, 10, 100, 1000, 10000, 100000}) {
+        for(int64_t churn : {0, 1000, 10}) b->Args({observers, churn});
+    }
+}
+
+BENCHMARK(BM_Notify<Observable>)->Name("Observable")->Apply(Cases)->UseRealTime();
+BENCHMARK(BM_Notify<ThreadSafeObservable>)->Name("ThreadSafeObservable")->Apply(Cases)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_Notify<CowObservable>)->Name("CowObservable")->Apply(Cases)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_Signals2)->Name("Observable2_signals2")->Apply(Cases)->ThreadRange(1, 16)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "field_id.hpp"
+#include "../common/epoch.hpp"
+
+// Forward Declaration
+template<typename> struct Observer;
+
+// CRTP, copy-on-write flavour of ThreadSafeObservable
+/*
+    notify never takes a lock: it loads the current immutable snapshot of the observer list and walks it.
+    subscribe/unsubscribe copy the list, edit the copy and atomically swap it in (RCU style), so the cost
+    of a change is paid by the writer and publishers never wait on each other or on a running callback.
+
+    Replaced snapshots are reclaimed through the shared EpochDomain: notify pins the epoch while it walks, and each
+    retired snapshot is freed as soon as the readers that could have loaded it are done. A reader that is
+    still busy only holds back the snapshots retired while it was pinned, not every later one, so snapshots
+    do not pile up under constant notify traffic.
+
+    Snapshot semantics: an observer that unsubscribes while a notify is in flight may still receive
+    that one in-flight notification.
+*/
+template<typename T>
+struct CowObservable
+{
+    typedef std::vector<Observer<T>*> list_t;
+
+private:
+    std::atomic<const list_t*> observers{new list_t{}};
+    EpochDomain &epochs{EpochDomain::shared()};
+
+    // writer side only
+    std::mutex write_mtx;
+
+    // called with write_mtx held
+    void publish(const list_t *next)
+    {
+        epochs.retire(observers.exchange(next));
+    }
+
+public:
+    CowObservable() = default;
+    CowObservable(const CowObservable&) = delete;
+    CowObservable& operator=(const CowObservable&) = delete;
+
+    ~CowObservable()
+    {
+        delete observers.load();
+    }
+
+    void notify(T& source, FieldId field)
+    {
+        auto guard = epochs.pin();
+        const list_t *snapshot = observers.load();
+        for(auto observer : *snapshot) {
+            observer->field_changed(source, field);
+        }
+    }
+
+    void subscribe(Observer<T> &observer)
+    {
+        std::scoped_lock<std::mutex> lock{write_mtx};
+        auto next = new list_t(*observers.load());
+        next->push_back(&observer);
+        publish(next);
+    }
+
+    void unsubscribe(Observer<T> &observer)
+    {
+        std::scoped_lock<std::mutex> lock{write_mtx};
+        auto next = new list_t(*observers.load());
+        next->erase(
+            std::remove(next->begin(), next->end(), &observer),
+            next->end()
+        );
+        publish(next);
+    }
+};
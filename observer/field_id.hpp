@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+// Compile-time field identifier passed through Observer<T>::field_changed
+/*
+    The id is the FNV-1a hash of the field name, computed at compile time, so notify does no allocation
+    and observers dispatch on an integer (it can even be a switch case label). The name is kept around
+    as a string_view to the literal for logging.
+
+    Only the 32-bit hash identifies a field, so two names that collide would be taken for the same field.
+    Debug builds (no NDEBUG) also compare the names in == and != and assert on such a collision; a
+    collision between constant fields then fails to compile, since the assert is hit during constant
+    evaluation.
+*/
+struct FieldId
+{
+    uint32_t id;
+    std::string_view name;
+
+    static constexpr uint32_t hash(std::string_view s)
+    {
+        uint32_t h = 2166136261u;
+        for(char c : s) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    explicit constexpr FieldId(std::string_view name) : id(hash(name)), name(name) {}
+
+    constexpr bool operator==(const FieldId &other) const
+    {
+        assert((id != other.id || name == other.name) && "FieldId: two field names share a hash");
+        return id == other.id;
+    }
+
+    constexpr bool operator!=(const FieldId &other) const { return !(*this == other); }
+
+    friend std::ostream& operator<<(std::ostream &os, const FieldId &field)
+    {
+        return os << field.name;
+    }
+};
+
+// "age"_field, always evaluated at compile time
+consteval FieldId operator""_field(const char *name, size_t len)
+{
+    return FieldId{std::string_view{name, len}};
+}
@@ -9,6 +9,9 @@ class Person : public ThreadSafeObservable<Person>       // Observable
 {
     int age_;
 public:
+    static constexpr FieldId age_field = "age"_field;
+    static constexpr FieldId can_vote_field = "can_vote"_field;
+
     Person(int age) : age_(age) {}
 
     int get_age()
@@ -22,10 +25,10 @@ public:
 
         auto old_can_vote = get_can_vote();
         this->age_ = age;
-        notify(*this, "age");
+        notify(*this, age_field);
 
         if(old_can_vote != get_can_vote()) {
-            notify(*this, "can_vote");
+            notify(*this, can_vote_field);
         }
     }
 
@@ -37,11 +40,13 @@ public:
 struct ConsolePersonObserver : public Observer<Person>          // Observer
 {
 private:
-    void field_changed(Person &source, const std::string &field_name) override
+    void field_changed(Person &source, FieldId field) override
     {
-        std::cout << "Person " << &source << " " << field_name << " has changed to ";
-        if(field_name == "age") std::cout << source.get_age();
-        if(field_name == "can_vote") std::cout << std::boolalpha << source.get_can_vote();
+        std::cout << "Person " << &source << " " << field << " has changed to ";
+        switch(field.id) {
+        case Person::age_field.id: std::cout << source.get_age(); break;
+        case Person::can_vote_field.id: std::cout << std::boolalpha << source.get_can_vote(); break;
+        }
         std::cout << "\n";
     }
 };
@@ -52,7 +57,7 @@ private:
 #include <boost/signals2.hpp>
 template <typename T> struct Observable2
 {
-    boost::signals2::signal<void(T&, const std::string&)> field_changed;
+    boost::signals2::signal<void(T&, FieldId)> field_changed;
 };
 
 class Person2 : public Observable2<Person2>
@@ -63,7 +68,7 @@ public:
     {
         if(this->age_ == age) return;
         this->age_ = age;
-        field_changed(*this, "age");
+        field_changed(*this, "age"_field);
     }
 
     int get_age() const {
@@ -75,7 +80,7 @@ public:
 
 struct TrafficAdministration : Observer<Person>
 {
-    void field_changed(Person &source, const std::string &field_name) override
+    void field_changed(Person &, FieldId) override
     {
         //if(source.get_age() < )
     }
@@ -95,9 +100,9 @@ int main() {
     // observer with boost
     // Person2 p2;
     // auto conn = p2.field_changed.connect(
-    //     [](Person2 &p, const std::string &field_name)
+    //     [](Person2 &p, FieldId field)
     //     {
-    //         std::cout << field_name << " has changed\n";
+    //         std::cout << field << " has changed\n";
     //     }
     // );
 
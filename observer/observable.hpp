@@ -1,25 +1,42 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <iostream>
-#include <string>
+#include <unordered_map>
 #include <vector>
+#include "field_id.hpp"
 
 // Forward Declaration
 template<typename> struct Observer;
 
 // CRTP -> Curiously recurring template pattern
+/*
+    Observers either subscribe to everything (wildcard) or to a single field. Per-field subscribers live in a
+    dispatch table keyed by FieldId::id, so notify only walks the wildcard list plus the one bucket for the
+    changed field instead of calling every observer on every change.
+*/
 template<typename T>
 struct Observable
 {
-    // vector of observer pointers
+    // vector of observer pointers, subscribed to every field
     std::vector<Observer<T>*> observers;
+
+    // FieldId::id -> observers of that field only
+    std::unordered_map<uint32_t, std::vector<Observer<T>*>> field_observers;
 public:
 
-    void notify(T& source, const std::string &field_name)
+    void notify(T& source, FieldId field)
     {
         for(auto observer : observers) {
-            observer->field_changed(source, field_name);
+            observer->field_changed(source, field);
+        }
+
+        if(field_observers.empty()) return;
+        auto it = field_observers.find(field.id);
+        if(it == field_observers.end()) return;
+        for(auto observer : it->second) {
+            observer->field_changed(source, field);
         }
     }
 
@@ -28,13 +45,40 @@ public:
         observers.push_back(&observer);
     }
 
+    void subscribe(Observer<T> &observer, FieldId field)
+    {
+        field_observers[field.id].push_back(&observer);
+    }
+
+    // removes the observer from the wildcard list and from every field it subscribed to
     void unsubscribe(Observer<T> &observer)
     {
         observers.erase(
             std::remove(observers.begin(), observers.end(), &observer),
             observers.end()
         );
+        for(auto it = field_observers.begin(); it != field_observers.end(); ) {
+            erase_from(it->second, observer);
+            it = it->second.empty() ? field_observers.erase(it) : std::next(it);
+        }
 
         std::cout << "observer " << &observer << " unsubscribed\n";
     }
+
+    void unsubscribe(Observer<T> &observer, FieldId field)
+    {
+        auto it = field_observers.find(field.id);
+        if(it == field_observers.end()) return;
+        erase_from(it->second, observer);
+        if(it->second.empty()) field_observers.erase(it);
+    }
+
+private:
+    static void erase_from(std::vector<Observer<T>*> &list, Observer<T> &observer)
+    {
+        list.erase(
+            std::remove(list.begin(), list.end(), &observer),
+            list.end()
+        );
+    }
 };
@@ -1,11 +1,11 @@
 #pragma once
-#include <string>
+#include "field_id.hpp"
 
 // T : the type of object to be observed
 template<typename T>
 struct Observer
 {
     virtual void field_changed(
-        T& source, const std::string &field_name
+        T& source, FieldId field
     ) = 0;
 };
@@ -2,59 +2,89 @@
 
 #include <iostream>
 #include <algorithm>
-#include <string>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
+#include "field_id.hpp"
 
 // Forward Declaration
 template<typename> struct Observer;
 
 // CRTP -> Curiously recurring template pattern
+/*
+    Removal is deferred: unsubscribe only writes a tombstone (nullptr) into the observer's slot, found in O(1)
+    through the index. The vector is compacted in one batch once enough tombstones pile up, and never while a
+    notify is walking it, so removal stays amortized O(1) and the walk never has its iterators invalidated.
+
+    The mutex is recursive, so an observer may subscribe/unsubscribe (itself or others) from inside field_changed.
+    Observers subscribed during a notify start receiving events from the next notify.
+*/
 template<typename T>
 struct ThreadSafeObservable
 {
-    // vector of observer pointers
+    // vector of observer pointers, nullptr marks a tombstone
     std::vector<Observer<T>*> observers;
 
-    typedef std::mutex mutex_t;
+    typedef std::recursive_mutex mutex_t;
     mutex_t mtx;
+
+private:
+    // compact once tombstones are at least COMPACT_MIN and a quarter of the vector
+    static constexpr size_t COMPACT_MIN = 32;
+
+    std::unordered_map<Observer<T>*, size_t> index;
+    size_t tombstones{0};
+    size_t notifying{0};            // notify depth, > 0 while somebody is walking observers
+
+    void maybe_compact()
+    {
+        if(notifying != 0 || tombstones < COMPACT_MIN || tombstones * 4 < observers.size()) return;
+
+        observers.erase(
+            std::remove(observers.begin(), observers.end(), nullptr),
+            observers.end()
+        );
+        for(size_t i = 0; i < observers.size(); ++i) index[observers[i]] = i;
+        tombstones = 0;
+    }
+
 public:
 
-    void notify(T& source, const std::string &field_name)
+    void notify(T& source, FieldId field)
     {
         std::scoped_lock<mutex_t> lock{mtx};
-        for(auto observer : observers) {
-            if(observer)
-                observer->field_changed(source, field_name);
-            else {              // Delete if nullptr
-                observers.erase(
-                    std::remove(observers.begin(), observers.end(), &observer),
-                    observers.end()
-                );
-                std::cout << "observer " << &observer << " unsubscribed\n";
-            }
+
+        struct depth_guard {
+            ThreadSafeObservable &self;
+            depth_guard(ThreadSafeObservable &self) : self(self) { ++self.notifying; }
+            ~depth_guard() { --self.notifying; self.maybe_compact(); }
+        } guard{*this};
+
+        // index based walk, callbacks may push_back and reallocate the vector
+        const size_t count = observers.size();
+        for(size_t i = 0; i < count; ++i) {
+            if(auto observer = observers[i])
+                observer->field_changed(source, field);
         }
     }
 
     void subscribe(Observer<T> &observer)
     {
         std::scoped_lock<mutex_t> lock{mtx};
+        if(index.count(&observer)) return;
+        index.emplace(&observer, observers.size());
         observers.push_back(&observer);
     }
 
     void unsubscribe(Observer<T> &observer)
     {
-        /*
-            to prevent recursive locking, if in notify we try to access unsubscribe it would have resulted
-            in a deadlock
-        */
-        auto it = std::find(std::begin(observers), std::end(observers), &observer);
-        if(it != std::end(observers)) *it = nullptr;
-        // std::scoped_lock<mutex_t> lock{mtx};
-        // observers.erase(
-        //     std::remove(observers.begin(), observers.end(), &observer),
-        //     observers.end()
-        // );
+        std::scoped_lock<mutex_t> lock{mtx};
+        auto it = index.find(&observer);
+        if(it == index.end()) return;
 
+        observers[it->second] = nullptr;
+        index.erase(it);
+        ++tombstones;
+        maybe_compact();
     }
 };
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <tuple>
+#include "field_id.hpp"
+
+// CRTP, observer set fixed at compile time
+/*
+    Observers are held by value in a tuple and notify is a fold over it, so every field_changed is a direct,
+    inlinable call: no vtable, no pointer chase, no subscribe/unsubscribe. Observers only need a
+    field_changed(T&, FieldId) member, they do not have to derive from Observer<T>.
+*/
+template<typename T, typename... Observers>
+struct StaticObservable
+{
+    std::tuple<Observers...> observers;
+public:
+
+    void notify(T& source, FieldId field)
+    {
+        std::apply([&](auto&... observer) { (observer.field_changed(source, field), ...); }, observers);
+    }
+
+    template<typename O>
+    O& observer()
+    {
+        return std::get<O>(observers);
+    }
+};
@@ -0,0 +1,170 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "observer.hpp"
+#include "async_observable.hpp"
+
+/*
+    Stress test for AsyncObservable, run once per back-pressure policy on a small ring so that it overflows all
+    the time. Publisher threads stamp one of their sources and notify it flat out, and flush() every few hundred
+    notifications; a slow observer records the stamp it finds in each source it is told about. After a seeded
+    random delay the main thread calls quiesce() while the publishers are still going; each publisher stops at
+    its first rejected notify. A round reports a violation when
+        - after a flush, or at the end, a source's last accepted stamp has not been seen (block and coalesce;
+          drop_oldest may legitimately drop it)
+        - the observer sees a stamp that was never set, or a foreign field
+        - deliveries do not add up: block delivers every accepted notification, drop_oldest delivers or drops
+          every one, coalesce delivers at most as many
+    Under block and drop_oldest a publisher cycles through enough sources that none repeats within a dispatcher
+    batch, so nothing is merged; under coalesce it cycles through a handful, so the overflow set folds.
+
+    build: g++ -std=c++20 -O1 -g -pthread -fsanitize=thread stress_async_observable.cc -o stress_async_observable
+    run:   ./stress_async_observable [threads] [rounds] [seed]
+*/
+
+static constexpr size_t RING_CAPACITY = 64;
+static constexpr size_t SOURCES_PER_THREAD = 1024;
+static constexpr size_t COALESCED_SOURCES = 8;     // of them, used under coalesce
+static constexpr size_t FLUSH_EVERY = 256;
+
+static const FieldId STAMP{"stamp"};
+
+struct Source
+{
+    std::atomic<uint64_t> stamp{0};         // set by the publisher before every notify
+    std::atomic<uint64_t> seen{0};          // last stamp the observer found
+    uint64_t accepted{0};                   // stamp of the last notify that was queued, publisher only
+};
+
+struct SlowObserver : Observer<Source>
+{
+    std::atomic<size_t> deliveries{0};
+    std::atomic<size_t> violations{0};
+
+    void field_changed(Source &source, FieldId field) override
+    {
+        if(field != STAMP) ++violations;
+        uint64_t stamp = source.stamp.load();
+        if(stamp == 0) ++violations;
+        source.seen.store(stamp);
+        if(++deliveries % 32 == 0) std::this_thread::yield();
+    }
+};
+
+struct RoundResult
+{
+    size_t notifies{0}, accepted{0}, deliveries{0}, dropped{0}, violations{0};
+};
+
+static RoundResult run_round(BackPressure policy, size_t threads, unsigned delay_ms)
+{
+    SlowObserver observer;
+    std::vector<std::unique_ptr<Source[]>> sources;
+    for(size_t t = 0; t < threads; ++t) sources.push_back(std::make_unique<Source[]>(SOURCES_PER_THREAD));
+
+    RoundResult result;
+    std::atomic<size_t> notifies{0}, accepted{0}, violations{0};
+    {
+        AsyncObservable<Source> hub{RING_CAPACITY, policy};
+        hub.subscribe(observer);
+
+        const size_t cycle = policy == BackPressure::coalesce ? COALESCED_SOURCES : SOURCES_PER_THREAD;
+        // every accepted stamp of these sources must have been seen
+        auto unseen = [&](Source *mine) {
+            size_t missing = 0;
+            for(size_t i = 0; i < SOURCES_PER_THREAD; ++i) {
+                if(mine[i].seen.load() < mine[i].accepted) ++missing;
+            }
+            return missing;
+        };
+
+        std::vector<std::thread> pool;
+        for(size_t t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                Source *mine = sources[t].get();
+                size_t sent = 0, queued = 0, bad = 0;
+                for(uint64_t n = 1;; ++n) {
+                    Source &source = mine[n % cycle];
+                    source.stamp.store(n);
+                    ++sent;
+                    if(!hub.notify(source, STAMP)) break;
+                    source.accepted = n;
+                    ++queued;
+                    if(n % FLUSH_EVERY == 0) {
+                        hub.flush();
+                        if(policy != BackPressure::drop_oldest) bad += unseen(mine);
+                    }
+                }
+                // quiesce() has begun: flush returns once it is done, and every accepted stamp is out by then
+                hub.flush();
+                if(policy != BackPressure::drop_oldest) bad += unseen(mine);
+                notifies += sent;
+                accepted += queued;
+                violations += bad;
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+        hub.quiesce();
+        for(auto &th : pool) th.join();
+        hub.flush();
+        result.dropped = hub.dropped_count();
+    }
+
+    result.notifies = notifies;
+    result.accepted = accepted;
+    result.deliveries = observer.deliveries;
+    result.violations = violations + observer.violations;
+    for(auto &mine : sources) {
+        for(size_t i = 0; i < SOURCES_PER_THREAD; ++i) {
+            if(mine[i].seen.load() > mine[i].stamp.load()) ++result.violations;
+        }
+    }
+    switch(policy) {
+    case BackPressure::block:
+        if(result.deliveries != result.accepted || result.dropped != 0) ++result.violations;
+        break;
+    case BackPressure::drop_oldest:
+        if(result.deliveries + result.dropped != result.accepted) ++result.violations;
+        break;
+    case BackPressure::coalesce:
+        if(result.deliveries > result.accepted || result.dropped != 0) ++result.violations;
+        break;
+    }
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    size_t threads = argc > 1 ? std::stoul(argv[1]) : 4;
+    size_t rounds = argc > 2 ? std::stoul(argv[2]) : 20;
+    unsigned seed = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 5;
+    std::mt19937 rng{seed};
+
+    size_t violations = 0;
+    std::cout << "policy,rounds,notifies,accepted,deliveries,dropped,violations\n";
+    for(auto [name, policy] : {std::pair{"block", BackPressure::block},
+                               std::pair{"drop_oldest", BackPressure::drop_oldest},
+                               std::pair{"coalesce", BackPressure::coalesce}}) {
+        RoundResult total;
+        for(size_t round = 0; round < rounds; ++round) {
+            RoundResult r = run_round(policy, threads, 5 + rng() % 45);
+            total.notifies += r.notifies;
+            total.accepted += r.accepted;
+            total.deliveries += r.deliveries;
+            total.dropped += r.dropped;
+            total.violations += r.violations;
+        }
+        violations += total.violations;
+        std::cout << name << "," << rounds << "," << total.notifies << "," << total.accepted << ","
+                  << total.deliveries << "," << total.dropped << "," << total.violations << "\n";
+    }
+    return violations == 0 ? 0 : 1;
+}
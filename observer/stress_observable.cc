@@ -0,0 +1,164 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "observer.hpp"
+#include "safe_observable.hpp"
+
+/*
+    Stress test for ThreadSafeObservable: several threads subscribe, unsubscribe and notify the same subject at
+    random while some observers re-enter it from inside field_changed (a toggle observer unsubscribes itself and
+    subscribes its partner, which must then wait for the next notify).
+
+    The harness takes no lock of its own: subscribe, unsubscribe and notify race inside ThreadSafeObservable.
+    Every observer walks through the phases unsubscribed -> subscribing -> subscribed -> unsubscribing, and
+    the subject counts the phase changes with atomics. A notify reads the counters before and after it runs:
+    every observer whose subscribe had returned before it started must hear it unless its unsubscribe began
+    meanwhile (lower bound), and nobody can hear it who had not at least begun subscribing (upper bound). A
+    round reports a violation when an observer is called while unsubscribed, when an observer is called twice
+    in one round, or when the number of deliveries falls outside those bounds.
+
+    build: g++ -std=c++20 -O1 -g -pthread -fsanitize=thread stress_observable.cc -o stress_observable
+    run:   ./stress_observable [threads] [seconds]
+*/
+
+static constexpr size_t OBSERVERS_PER_THREAD = 64;
+static constexpr size_t TOGGLE_PAIRS = 8;
+
+struct Subject;
+
+// the round being notified and its deliveries so far, of the thread running notify
+static thread_local uint64_t current_round = 0;
+static thread_local size_t delivered = 0;
+
+struct CheckedObserver : Observer<Subject>
+{
+    enum Phase { UNSUBSCRIBED, SUBSCRIBING, SUBSCRIBED, UNSUBSCRIBING };
+
+    std::atomic<int> phase{UNSUBSCRIBED};
+    std::atomic<uint64_t> last_round{0};
+
+    void field_changed(Subject &source, FieldId field) override;
+    virtual void react(Subject &) {}
+};
+
+struct Subject : ThreadSafeObservable<Subject>
+{
+    std::atomic<uint64_t> rounds{0};
+    std::atomic<int64_t> subscribes_started{0}, subscribes_done{0}, unsubscribes_started{0}, unsubscribes_done{0};
+    std::atomic<size_t> violations{0};
+    std::atomic<size_t> deliveries{0};
+
+    void add(CheckedObserver &observer)
+    {
+        int expected = CheckedObserver::UNSUBSCRIBED;
+        if(!observer.phase.compare_exchange_strong(expected, CheckedObserver::SUBSCRIBING)) return;
+        ++subscribes_started;
+        subscribe(observer);
+        observer.phase = CheckedObserver::SUBSCRIBED;
+        ++subscribes_done;
+    }
+
+    void remove(CheckedObserver &observer)
+    {
+        int expected = CheckedObserver::SUBSCRIBED;
+        if(!observer.phase.compare_exchange_strong(expected, CheckedObserver::UNSUBSCRIBING)) return;
+        ++unsubscribes_started;
+        unsubscribe(observer);
+        observer.phase = CheckedObserver::UNSUBSCRIBED;
+        ++unsubscribes_done;
+    }
+
+    void publish()
+    {
+        // read so that both bounds err on the loose side: a counter read later only widens them
+        int64_t subscribed = subscribes_done.load();
+        int64_t leaving_before = unsubscribes_started.load();
+        int64_t left = unsubscribes_done.load();
+        int64_t joining_before = subscribes_started.load();
+
+        current_round = ++rounds;
+        delivered = 0;
+        notify(*this, FieldId{"value"});
+        const auto got = static_cast<int64_t>(delivered);
+
+        int64_t lower = subscribed - leaving_before - (unsubscribes_started.load() - leaving_before);
+        int64_t upper = joining_before - left + (subscribes_started.load() - joining_before);
+        if(got < lower || got > upper) ++violations;
+        deliveries += delivered;
+    }
+};
+
+void CheckedObserver::field_changed(Subject &source, FieldId)
+{
+    if(phase.load() == UNSUBSCRIBED) ++source.violations;
+    if(last_round.exchange(current_round) == current_round) ++source.violations;
+    ++delivered;
+    react(source);
+}
+
+// hands its subscription over to its partner from inside the callback
+struct ToggleObserver : CheckedObserver
+{
+    ToggleObserver *partner{nullptr};
+
+    void react(Subject &source) override
+    {
+        source.remove(*this);
+        source.add(*partner);
+    }
+};
+
+int main(int argc, char **argv)
+{
+    size_t threads = argc > 1 ? std::stoul(argv[1]) : 4;
+    double seconds = argc > 2 ? std::stod(argv[2]) : 2.0;
+
+    Subject subject;
+
+    std::vector<std::unique_ptr<ToggleObserver>> toggles;
+    for(size_t i = 0; i < TOGGLE_PAIRS * 2; ++i) toggles.push_back(std::make_unique<ToggleObserver>());
+    for(size_t i = 0; i < TOGGLE_PAIRS; ++i) {
+        toggles[2 * i]->partner = toggles[2 * i + 1].get();
+        toggles[2 * i + 1]->partner = toggles[2 * i].get();
+        subject.add(*toggles[2 * i]);
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> operations{0}, notifies{0};
+    std::vector<std::thread> pool;
+    for(size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            std::mt19937 rng{static_cast<unsigned>(t + 1)};
+            std::vector<CheckedObserver> mine(OBSERVERS_PER_THREAD);
+            size_t ops = 0, published = 0;
+            while(!stop.load(std::memory_order_relaxed)) {
+                auto &observer = mine[rng() % mine.size()];
+                switch(rng() % 4) {
+                case 0: subject.add(observer); break;
+                case 1: subject.remove(observer); break;
+                default: subject.publish(); ++published; break;
+                }
+                ++ops;
+            }
+            for(auto &observer : mine) subject.remove(observer);
+            operations += ops;
+            notifies += published;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for(auto &th : pool) th.join();
+
+    std::cout << "threads,operations,notifies,deliveries,violations\n";
+    std::cout << threads << "," << operations << "," << notifies << "," << subject.deliveries << ","
+              << subject.violations << "\n";
+    return subject.violations == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "caching_database.hpp"
+#include "city_table.hpp"
+#include "database.hpp"
+
+/*
+    CachingDatabase in front of a slow backing store, Zipf distributed lookups.
+    The stand-in "remote" database spins for ~2us per lookup (network round trip, disk read, ...).
+
+    build: g++ -std=c++20 -O2 -pthread bench_cache.cc -o bench_cache
+*/
+
+static constexpr size_t CITIES = 100'000;
+static constexpr size_t CACHE_CAPACITY = 10'000;
+static constexpr size_t LOOKUPS = 400'000;
+
+struct SlowDatabase : Database
+{
+    const CityTable &table;
+    SlowDatabase(const CityTable &table) : table(table) {}
+
+    int get_population(const std::string &name) override
+    {
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(2);
+        while(std::chrono::steady_clock::now() < until) {}
+        return table.find(name).value_or(0);
+    }
+};
+
+// rank r (0 based) is drawn with probability proportional to 1 / (r + 1)^s
+struct Zipf
+{
+    std::vector<double> cdf;
+    Zipf(size_t n, double s) : cdf(n)
+    {
+        double sum = 0;
+        for(size_t r = 0; r < n; ++r) cdf[r] = (sum += 1.0 / std::pow(r + 1.0, s));
+        for(auto &c : cdf) c /= sum;
+    }
+    template<typename Rng> size_t operator()(Rng &rng)
+    {
+        double u = std::uniform_real_distribution<double>{0, 1}(rng);
+        return std::min<size_t>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin(), cdf.size() - 1);
+    }
+};
+
+template<typename Db>
+double run(Db &db, const std::vector<std::string> &queries, size_t threads)
+{
+    std::vector<std::thread> pool;
+    const size_t per_thread = queries.size() / threads;
+    auto start = std::chrono::steady_clock::now();
+    for(size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            int64_t sum = 0;
+            for(size_t i = t * per_thread; i < (t + 1) * per_thread; ++i) sum += db.get_population(queries[i]);
+            if(sum == 42) std::cout << "";
+        });
+    }
+    for(auto &th : pool) th.join();
+    return (per_thread * threads) / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    std::vector<std::string> cities;
+    std::vector<std::pair<std::string_view, int>> entries;
+    for(size_t i = 0; i < CITIES; ++i) cities.push_back("City_" + std::to_string(i));
+    for(size_t i = 0; i < CITIES; ++i) entries.emplace_back(cities[i], static_cast<int>(i));
+    CityTable table{entries};
+    SlowDatabase slow{table};
+
+    std::cout << "zipf_s,threads,direct_lookups_per_sec,cached_lookups_per_sec,hit_ratio,evictions\n";
+    for(double s : {0.8, 1.0, 1.2}) {
+        std::mt19937_64 rng{3};
+        Zipf zipf{CITIES, s};
+        std::vector<std::string> queries;
+        queries.reserve(LOOKUPS);
+        for(size_t i = 0; i < LOOKUPS; ++i) queries.push_back(cities[zipf(rng)]);
+
+        for(size_t threads : {1, 4}) {
+            CachingDatabase cached{slow, CACHE_CAPACITY};
+            auto direct_rate = run(slow, queries, threads);
+            auto cached_rate = run(cached, queries, threads);
+            auto stats = cached.stats();
+            std::cout << s << "," << threads << "," << direct_rate << "," << cached_rate << ","
+                      << static_cast<double>(stats.hits) / (stats.hits + stats.misses) << "," << stats.evictions << "\n";
+        }
+    }
+    return 0;
+}
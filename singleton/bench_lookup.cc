@@ -0,0 +1,80 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "city_table.hpp"
+
+/*
+    get_population lookup cost on a 1M city dataset: std::map (the old SingletonDatabase storage) vs CityTable.
+    90% of the lookups hit, 10% ask for cities that do not exist.
+
+    build: g++ -std=c++20 -O2 -pthread bench_lookup.cc -o bench_lookup
+*/
+
+static constexpr size_t CITIES = 1'000'000;
+static constexpr size_t LOOKUPS = 4'000'000;
+
+template<typename Lookup>
+double lookups_per_sec(const std::vector<std::string> &queries, size_t threads, Lookup lookup)
+{
+    std::atomic<int64_t> checksum{0};
+    std::vector<std::thread> pool;
+    const size_t per_thread = queries.size() / threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for(size_t t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            int64_t sum = 0;
+            for(size_t i = t * per_thread; i < (t + 1) * per_thread; ++i) sum += lookup(queries[i]);
+            checksum += sum;
+        });
+    }
+    for(auto &th : pool) th.join();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if(checksum.load() == 42) std::cout << "";           // keep the sum alive
+    return (per_thread * threads) / elapsed;
+}
+
+int main()
+{
+    std::mt19937_64 rng{2024};
+    std::vector<std::string> names;
+    names.reserve(CITIES);
+    for(size_t i = 0; i < CITIES; ++i) names.push_back("City_" + std::to_string(rng()));
+
+    std::map<std::string, int> map;
+    std::vector<std::pair<std::string_view, int>> entries;
+    for(size_t i = 0; i < CITIES; ++i) {
+        map[names[i]] = static_cast<int>(i);
+        entries.emplace_back(names[i], static_cast<int>(i));
+    }
+    CityTable table{entries};
+
+    std::vector<std::string> queries;
+    queries.reserve(LOOKUPS);
+    for(size_t i = 0; i < LOOKUPS; ++i) {
+        if(i % 10 == 9) queries.push_back("Missing_" + std::to_string(rng()));
+        else queries.push_back(names[rng() % CITIES]);
+    }
+
+    std::cout << "threads,std_map_lookups_per_sec,city_table_lookups_per_sec\n";
+    for(size_t threads : {1, 4}) {
+        // find, not operator[]: the old operator[] inserted on a miss and could not run concurrently at all
+        auto map_rate = lookups_per_sec(queries, threads, [&](const std::string &q) {
+            auto it = map.find(q);
+            return it == map.end() ? 0 : it->second;
+        });
+        auto table_rate = lookups_per_sec(queries, threads, [&](const std::string &q) {
+            return table.find(q).value_or(0);
+        });
+        std::cout << threads << "," << map_rate << "," << table_rate << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "database.hpp"
+
+/*
+    Reader throughput of SingletonDatabase while the table is reloaded back to back.
+
+    Generation g of the dataset gives every city the population g, so each batch a reader gets back must be
+    uniform (one version, never a mix) and generations must never go backwards for a reader. Violations are
+    counted and reported next to the throughput.
+
+    build: g++ -std=c++20 -O2 -pthread bench_reload.cc -o bench_reload
+    run:   ./bench_reload [reader_threads] [seconds]     (works in a temporary directory)
+*/
+
+static constexpr size_t CITIES = 100'000;
+static constexpr size_t BATCH = 256;
+
+static void write_generation(int generation)
+{
+    // write + rename so the loader never maps a half written file
+    {
+        std::ofstream ofs("capitals.txt.tmp");
+        for(size_t i = 0; i < CITIES; ++i) ofs << "City_" << i << "\n" << generation << "\n";
+    }
+    std::rename("capitals.txt.tmp", SingletonDatabase::CAPITALS_TXT);
+}
+
+struct Result
+{
+    double lookups_per_sec;
+    size_t reloads;
+    size_t violations;
+};
+
+static Result run(size_t readers, double seconds, bool reloading)
+{
+    auto &db = SingletonDatabase::getInstance();
+
+    std::vector<std::string> names;
+    for(size_t i = 0; i < CITIES; ++i) names.push_back("City_" + std::to_string(i));
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> lookups{0}, violations{0}, reloads{0};
+
+    std::vector<std::thread> pool;
+    for(size_t t = 0; t < readers; ++t) {
+        pool.emplace_back([&, t] {
+            std::vector<std::string_view> keys(BATCH);
+            std::vector<int64_t> out(BATCH);
+            int64_t last = 0;
+            size_t done = 0, bad = 0;
+            for(size_t round = t; !stop.load(std::memory_order_relaxed); ++round) {
+                for(size_t i = 0; i < BATCH; ++i) keys[i] = names[(round * BATCH + i * 7919) % CITIES];
+                db.get_populations(keys, out);
+                for(auto v : out) if(v != out[0]) ++bad;
+                if(out[0] < last) ++bad;
+                last = out[0];
+                done += BATCH;
+            }
+            lookups += done;
+            violations += bad;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::duration<double>(seconds);
+    for(int generation = 2; std::chrono::steady_clock::now() < deadline; ++generation) {
+        if(!reloading) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        write_generation(generation);
+        db.reload();
+        ++reloads;
+    }
+    stop = true;
+    for(auto &th : pool) th.join();
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return Result{lookups / elapsed, reloads.load(), violations.load()};
+}
+
+int main(int argc, char **argv)
+{
+    size_t readers = argc > 1 ? std::stoul(argv[1]) : 4;
+    double seconds = argc > 2 ? std::stod(argv[2]) : 3.0;
+
+    auto dir = std::filesystem::temp_directory_path() / "bench_reload";
+    std::filesystem::create_directories(dir);
+    std::filesystem::current_path(dir);
+    std::filesystem::remove(SingletonDatabase::CAPITALS_SNAP);
+    write_generation(1);
+    SingletonDatabase::getInstance();
+
+    std::cout << "mode,readers,lookups_per_sec,reloads,violations\n";
+    for(bool reloading : {false, true}) {
+        auto r = run(readers, seconds, reloading);
+        std::cout << (reloading ? "reloading" : "static") << "," << readers << "," << r.lookups_per_sec << ","
+                  << r.reloads << "," << r.violations << "\n";
+    }
+    return 0;
+}
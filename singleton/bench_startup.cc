@@ -0,0 +1,68 @@
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/lexical_cast.hpp>
+#include "capitals_loader.hpp"
+#include "city_table.hpp"
+#include "snapshot.hpp"
+
+/*
+    SingletonDatabase startup cost on a generated capitals file (10M records by default):
+    getline + boost::lexical_cast (the old constructor) vs the mmap + from_chars loader vs opening a compiled
+    binary snapshot.
+
+    build: g++ -std=c++20 -O2 bench_startup.cc -o bench_startup
+    run:   ./bench_startup [path] [records]
+*/
+
+static void generate(const std::string &path, size_t records)
+{
+    std::mt19937_64 rng{7};
+    std::ofstream ofs(path);
+    for(size_t i = 0; i < records; ++i) {
+        ofs << "City_" << rng() << "\n" << rng() % 40'000'000 << "\n";
+    }
+}
+
+static CityTable load_getline(const std::string &path)
+{
+    std::ifstream ifs(path);
+    std::string city, population;
+    std::vector<std::pair<std::string, int>> rows;
+    while(getline(ifs, city)) {
+        getline(ifs, population);
+        rows.emplace_back(city, boost::lexical_cast<int>(population));
+    }
+    std::vector<std::pair<std::string_view, int>> entries(rows.begin(), rows.end());
+    return CityTable{entries};
+}
+
+template<typename Load>
+void time_load(const char *name, Load load)
+{
+    auto start = std::chrono::steady_clock::now();
+    CityTable table = load();
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << "," << table.size() << "," << elapsed << "\n";
+}
+
+int main(int argc, char **argv)
+{
+    std::string path = argc > 1 ? argv[1] : "/tmp/capitals_10m.txt";
+    size_t records = argc > 2 ? std::stoul(argv[2]) : 10'000'000;
+    generate(path, records);
+
+    std::cout << "loader,cities,startup_ms\n";
+    time_load("getline_lexical_cast", [&] { return load_getline(path); });
+    time_load("mmap_from_chars", [&] { return load_capitals(path).value_or(CityTable{}); });
+
+    auto entries = load_capital_entries(path);
+    write_snapshot(path, path + ".snap", entries->rows);
+    time_load("binary_snapshot", [&] { return open_snapshot(path + ".snap", path).value_or(CityTable{}); });
+    return 0;
+}
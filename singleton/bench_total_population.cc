@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "city_table.hpp"
+#include "database.hpp"
+#include "record_finder.hpp"
+
+/*
+    total_population over 500k names against a 1M city table:
+    per_name -> a Database that only implements get_population (one virtual call + std::string per name)
+    batched  -> the same table behind get_populations (bulk hash, prefetch, SIMD sum)
+
+    build: g++ -std=c++20 -O2 -march=native bench_total_population.cc -o bench_total_population
+*/
+
+static constexpr size_t CITIES = 1'000'000;
+static constexpr size_t NAMES = 500'000;
+static constexpr int ROUNDS = 10;
+
+struct PerNameDatabase : Database
+{
+    const CityTable &table;
+    PerNameDatabase(const CityTable &table) : table(table) {}
+
+    int get_population(const std::string &name) override
+    {
+        return table.find(name).value_or(0);
+    }
+};
+
+struct BatchedDatabase : PerNameDatabase
+{
+    using PerNameDatabase::PerNameDatabase;
+
+    void get_populations(std::span<const std::string_view> names, std::span<int64_t> out) override
+    {
+        table.find_batch(names, out);
+    }
+};
+
+template<typename Db>
+void run(const char *name, Db &db, std::vector<std::string> &names)
+{
+    ConfigurableRecordFinder finder{db};
+    int64_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < ROUNDS; ++r) total = finder.total_population(names);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << "," << (NAMES * ROUNDS) / elapsed << "," << total << "\n";
+}
+
+int main()
+{
+    std::mt19937_64 rng{11};
+    std::vector<std::string> cities;
+    std::vector<std::pair<std::string_view, int>> entries;
+    cities.reserve(CITIES);
+    for(size_t i = 0; i < CITIES; ++i) cities.push_back("City_" + std::to_string(rng()));
+    for(auto &c : cities) entries.emplace_back(c, static_cast<int>(rng() % 40'000'000));
+    CityTable table{entries};
+
+    std::vector<std::string> names;
+    names.reserve(NAMES);
+    for(size_t i = 0; i < NAMES; ++i) names.push_back(cities[rng() % CITIES]);
+
+    PerNameDatabase per_name{table};
+    BatchedDatabase batched{table};
+
+    std::cout << "path,names_per_sec,total\n";
+    run("per_name", per_name, names);
+    run("batched", batched, names);
+    return 0;
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "database.hpp"
+
+// Read-through cache decorator for any Database
+/*
+    Hot cities are answered from memory, everything else goes to the wrapped Database and is remembered.
+    The cache is split into shards by key hash, each with its own mutex, so concurrent lookups of different
+    cities rarely meet on a lock. Every shard is a fixed array of entries evicted with CLOCK (second chance):
+    a hit only sets a reference bit, the hand clears bits as it sweeps and evicts the first entry it finds
+    unreferenced. The wrapped Database is called outside any shard lock.
+*/
+class CachingDatabase : public Database
+{
+public:
+    struct Stats
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+    };
+
+private:
+    static constexpr size_t SHARDS = 16;
+
+    struct Entry
+    {
+        std::string key;
+        int population{0};
+        bool referenced{false};
+    };
+
+    // lets the index be probed with a string_view, no temporary std::string per lookup
+    struct KeyHash
+    {
+        using is_transparent = void;
+        size_t operator()(std::string_view key) const { return std::hash<std::string_view>{}(key); }
+    };
+
+    struct alignas(64) Shard
+    {
+        std::mutex mtx;
+        std::vector<Entry> entries;                         // at most capacity, filled up before evicting
+        std::unordered_map<std::string, size_t, KeyHash, std::equal_to<>> index;     // key -> position in entries
+        size_t hand{0};
+    };
+
+    Database &backing_;
+    size_t shard_capacity_;
+    Shard shards_[SHARDS];
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+
+    Shard& shard_for(std::string_view key)
+    {
+        return shards_[std::hash<std::string_view>{}(key) % SHARDS];
+    }
+
+    bool lookup(std::string_view key, int &population)
+    {
+        Shard &shard = shard_for(key);
+        std::scoped_lock<std::mutex> lock{shard.mtx};
+        auto it = shard.index.find(key);
+        if(it == shard.index.end()) return false;
+
+        Entry &entry = shard.entries[it->second];
+        entry.referenced = true;
+        population = entry.population;
+        return true;
+    }
+
+    void insert(std::string_view key, int population)
+    {
+        Shard &shard = shard_for(key);
+        std::scoped_lock<std::mutex> lock{shard.mtx};
+        if(shard.index.find(key) != shard.index.end()) return;     // another thread filled it meanwhile
+        std::string k{key};
+
+        if(shard.entries.size() < shard_capacity_) {
+            shard.index.emplace(k, shard.entries.size());
+            shard.entries.push_back(Entry{std::move(k), population, false});
+            return;
+        }
+
+        // CLOCK sweep: second chance for referenced entries
+        for(;;) {
+            Entry &victim = shard.entries[shard.hand];
+            if(!victim.referenced) break;
+            victim.referenced = false;
+            shard.hand = (shard.hand + 1) % shard.entries.size();
+        }
+
+        Entry &victim = shard.entries[shard.hand];
+        shard.index.erase(victim.key);
+        shard.index.emplace(k, shard.hand);
+        victim = Entry{std::move(k), population, false};
+        shard.hand = (shard.hand + 1) % shard.entries.size();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+public:
+    // capacity: total number of cities kept, spread over the shards
+    CachingDatabase(Database &backing, size_t capacity)
+        : backing_(backing), shard_capacity_(std::max<size_t>(capacity / SHARDS, 1))
+    {
+        for(auto &shard : shards_) {
+            shard.entries.reserve(shard_capacity_);
+            shard.index.reserve(shard_capacity_);
+        }
+    }
+
+    int get_population(const std::string& name) override {
+        int population;
+        if(lookup(name, population)) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return population;
+        }
+
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        population = backing_.get_population(name);
+        insert(name, population);
+        return population;
+    }
+
+    // hits are answered from the cache, all misses of the batch go to the backing store in one batch call
+    void get_populations(std::span<const std::string_view> names, std::span<int64_t> out) override {
+        std::vector<std::string_view> missing;
+        std::vector<size_t> positions;
+
+        for(size_t i = 0; i < names.size(); ++i) {
+            int population;
+            if(lookup(names[i], population)) out[i] = population;
+            else {
+                missing.push_back(names[i]);
+                positions.push_back(i);
+            }
+        }
+        hits_.fetch_add(names.size() - missing.size(), std::memory_order_relaxed);
+        misses_.fetch_add(missing.size(), std::memory_order_relaxed);
+        if(missing.empty()) return;
+
+        std::vector<int64_t> fetched(missing.size());
+        backing_.get_populations(missing, fetched);
+        for(size_t j = 0; j < missing.size(); ++j) {
+            out[positions[j]] = fetched[j];
+            insert(missing[j], static_cast<int>(fetched[j]));
+        }
+    }
+
+    Stats stats() const
+    {
+        return Stats{hits_.load(), misses_.load(), evictions_.load()};
+    }
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "city_table.hpp"
+#include "mapped_file.hpp"
+
+// Loader for the capitals.txt format: a city name line followed by a population line
+/*
+    The file is memory mapped and parsed in place: load_capital_entries returns city names as string_views into
+    the mapping, and populations go through std::from_chars. Apart from the entry vector (reserved up front
+    from a newline count) there is no per-record allocation.
+
+    load_capitals then copies the names into one pool owned by the CityTable and lets the mapping go. A table
+    must not point into capitals.txt: the mapping is MAP_PRIVATE, so a rewrite of the file in place (an editor
+    saving, a truncate) would show up in it as torn names or SIGBUS for every reader of a table that is still
+    in service. The mapping is only read during the parse; capitals.snap is only ever replaced by rename (see
+    write_snapshot), which is why the snapshot can be served from its mapping.
+
+    A record whose population line is not entirely an integer is skipped. CityTable addresses names with 32-bit
+    offsets, so a file larger than that is rejected by load_capitals.
+*/
+struct CapitalEntries
+{
+    std::shared_ptr<const MappedFile> file;                 // rows point into it
+    std::vector<std::pair<std::string_view, int>> rows;
+};
+
+// nullopt if the file cannot be mapped
+inline std::optional<CapitalEntries> load_capital_entries(const std::string &path)
+{
+    auto file = MappedFile::open(path);
+    if(!file) return std::nullopt;
+
+    CapitalEntries entries;
+    const char *begin = file->data();
+    const char *end = begin + file->size();
+
+    auto next_line = [end](const char *&p) {
+        const char *eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if(!eol) eol = end;
+        std::string_view line{p, static_cast<size_t>(eol - p)};
+        if(!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        p = eol == end ? end : eol + 1;
+        return line;
+    };
+
+    entries.rows.reserve(std::count(begin, end, '\n') / 2 + 1);
+
+    for(const char *p = begin; p < end; ) {
+        std::string_view city = next_line(p);
+        if(p >= end) break;
+        std::string_view population = next_line(p);
+
+        int value = 0;
+        const char *last = population.data() + population.size();
+        auto [ptr, ec] = std::from_chars(population.data(), last, value);
+        if(ec != std::errc{} || ptr != last || city.empty()) continue;      // "12abc" is not 12
+        entries.rows.emplace_back(city, value);
+    }
+
+    entries.file = std::move(file);
+    return entries;
+}
+
+// nullopt if the file cannot be mapped or is too large for CityTable's 32-bit offsets
+inline std::optional<CityTable> load_capitals(const std::string &path)
+{
+    auto entries = load_capital_entries(path);
+    if(!entries) return std::nullopt;
+    if(!entries->file->data()) return CityTable{};          // empty file, empty table
+    if(entries->file->size() > CityTable::MAX_OFFSET) return std::nullopt;
+
+    // names are copied, the table does not keep the mapping alive
+    return CityTable{entries->rows};
+}
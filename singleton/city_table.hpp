@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Immutable city -> population table
+/*
+    Open addressing with linear probing, built once and never written again, so any number of threads can
+    read it concurrently without locks (reads are wait-free). Lookups take a std::string_view, so callers
+    holding a std::string, a literal or a slice of a larger buffer never build a temporary, and a miss is
+    just a miss: nothing gets inserted.
+
+    A slot keeps the 32-bit hash, the name's offset/length in a character pool and the population, 16 bytes
+    in total. The pool is either a copy of the names, or (zero-copy) a buffer the names already live in, such
+    as a memory mapped file; the table holds a reference to whatever owns it. Offsets are 32-bit, so the pool
+    is limited to 4 GiB. The slot array itself can live in a mapping too (see snapshot.hpp), in which case
+    the table is usable the moment the file is mapped. Such a slot array is not trusted: a probe stops after
+    slot_count slots even if none is empty, and a slot is only compared against the name once its
+    offset/length is known to lie inside the pool.
+*/
+class CityTable
+{
+public:
+    struct Slot
+    {
+        uint32_t hash;
+        uint32_t offset;
+        uint32_t length;        // 0 -> empty slot
+        int32_t population;
+    };
+
+    // slots address names with 32-bit offsets
+    static constexpr size_t MAX_OFFSET = UINT32_MAX;
+
+    static uint32_t hash(std::string_view name)
+    {
+        // FNV-1a 64, folded
+        uint64_t h = 14695981039346656037ull;
+        for(char c : name) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return static_cast<uint32_t>(h ^ (h >> 32));
+    }
+
+    CityTable() = default;
+
+    // entries with the same name: last one wins, like capitals[city] = population
+    // names are copied into a pool owned by the table
+    explicit CityTable(const std::vector<std::pair<std::string_view, int>> &entries)
+    {
+        auto pool = std::make_shared<std::string>();
+        size_t total = 0;
+        for(auto &entry : entries) total += entry.first.size();
+        pool->reserve(total);
+        for(auto &entry : entries) pool->append(entry.first);
+
+        std::vector<std::pair<std::string_view, int>> pooled;
+        pooled.reserve(entries.size());
+        size_t offset = 0;
+        for(auto &[name, population] : entries) {
+            pooled.emplace_back(std::string_view{pool->data() + offset, name.size()}, population);
+            offset += name.size();
+        }
+        const char *base = pool->data();
+        insert_all(pooled, base, std::move(pool));
+    }
+
+    // zero-copy: every name must point into [base, base + 4 GiB) of a buffer kept alive by backing
+    // throws std::length_error if one does not, rather than truncating its offset
+    CityTable(const std::vector<std::pair<std::string_view, int>> &entries,
+              const char *base, std::shared_ptr<const void> backing)
+    {
+        insert_all(entries, base, std::move(backing));
+    }
+
+    // adopts an already built slot array (power of two long) and pool of pool_size bytes, both kept alive by backing
+    CityTable(const Slot *slots, size_t slot_count, size_t size, const char *pool, size_t pool_size,
+              std::shared_ptr<const void> backing)
+        : slots_(slots), pool_(pool), backing_(std::move(backing)), mask_(slot_count - 1), size_(size),
+          pool_size_(pool_size)
+    {
+    }
+
+    std::optional<int> find(std::string_view name) const
+    {
+        if(!slots_) return std::nullopt;
+
+        uint32_t h = hash(name);
+        for(size_t n = 0, i = h & mask_; n <= mask_; ++n, i = (i + 1) & mask_) {
+            const Slot &slot = slots_[i];
+            if(slot.length == 0) return std::nullopt;
+            if(slot.hash == h && in_pool(slot) && key(slot) == name) return slot.population;
+        }
+        return std::nullopt;
+    }
+
+    // out[i] = population of names[i], 0 for a miss
+    /*
+        Works in blocks: hash the whole block first and prefetch every home slot, then probe. The slot loads
+        of a block overlap instead of each lookup waiting on its own cache miss.
+    */
+    void find_batch(std::span<const std::string_view> names, std::span<int64_t> out) const
+    {
+        static constexpr size_t BLOCK = 16;
+        uint32_t hashes[BLOCK];
+
+        for(size_t base = 0; base < names.size(); base += BLOCK) {
+            const size_t n = std::min(BLOCK, names.size() - base);
+            if(!slots_) {
+                std::fill_n(out.begin() + base, n, 0);
+                continue;
+            }
+
+            for(size_t j = 0; j < n; ++j) {
+                hashes[j] = hash(names[base + j]);
+                __builtin_prefetch(&slots_[hashes[j] & mask_]);
+            }
+            for(size_t j = 0; j < n; ++j) {
+                out[base + j] = probe(names[base + j], hashes[j]);
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    // raw layout, used to write snapshots
+    const Slot* slots() const { return slots_; }
+    size_t slot_count() const { return slots_ ? mask_ + 1 : 0; }
+    const char* pool() const { return pool_; }
+
+private:
+    void insert_all(const std::vector<std::pair<std::string_view, int>> &entries, const char *base,
+                    std::shared_ptr<const void> pool_owner)
+    {
+        struct Storage
+        {
+            std::shared_ptr<const void> pool_owner;
+            std::vector<Slot> slots;
+        };
+        auto storage = std::make_shared<Storage>();
+        storage->pool_owner = std::move(pool_owner);
+        std::vector<Slot> &slots = storage->slots;
+        // load factor <= 0.5 keeps probe sequences short
+        slots.assign(std::bit_ceil(std::max<size_t>(entries.size() * 2, 16)), Slot{0, 0, 0, 0});
+
+        pool_ = base;
+        slots_ = slots.data();
+        mask_ = slots.size() - 1;
+        backing_ = std::move(storage);
+
+        for(auto &[name, population] : entries) {
+            if(name.empty()) continue;
+            uint32_t h = hash(name);
+            size_t i = h & mask_;
+            while(slots[i].length != 0 && !(slots[i].hash == h && key(slots[i]) == name)) i = (i + 1) & mask_;
+
+            if(slots[i].length == 0) {
+                auto offset = static_cast<size_t>(name.data() - base);
+                if(offset > MAX_OFFSET || name.size() > MAX_OFFSET) throw std::length_error("CityTable: name beyond the 4 GiB pool limit");
+                slots[i] = Slot{h, static_cast<uint32_t>(offset), static_cast<uint32_t>(name.size()), 0};
+                pool_size_ = std::max(pool_size_, offset + name.size());
+                ++size_;
+            }
+            slots[i].population = population;
+        }
+    }
+
+    int probe(std::string_view name, uint32_t h) const
+    {
+        for(size_t n = 0, i = h & mask_; n <= mask_; ++n, i = (i + 1) & mask_) {
+            const Slot &slot = slots_[i];
+            if(slot.length == 0) return 0;
+            if(slot.hash == h && in_pool(slot) && key(slot) == name) return slot.population;
+        }
+        return 0;
+    }
+
+    // offset and length are 32-bit, their sum cannot wrap in 64
+    bool in_pool(const Slot &slot) const
+    {
+        return uint64_t{slot.offset} + slot.length <= pool_size_;
+    }
+
+    std::string_view key(const Slot &slot) const
+    {
+        return std::string_view{pool_ + slot.offset, slot.length};
+    }
+
+    const Slot *slots_{nullptr};
+    const char *pool_{nullptr};
+    std::shared_ptr<const void> backing_;       // owns the memory slots_ and pool_ point into
+    size_t mask_{0};
+    size_t size_{0};
+    size_t pool_size_{0};                       // bytes of pool_ that slots may point into
+};
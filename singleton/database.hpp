@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include "capitals_loader.hpp"
+#include "city_table.hpp"
+#include "../common/epoch.hpp"
+#include "snapshot.hpp"
+
+class Database
+{
+public:
+    virtual int get_population(const std::string& name) = 0;
+
+    // Batch lookup: out[i] = population of names[i]
+    // The default is one get_population call per name, so existing implementations keep working unchanged
+    virtual void get_populations(std::span<const std::string_view> names, std::span<int64_t> out) {
+        for(size_t i = 0; i < names.size(); ++i) {
+            out[i] = get_population(std::string{names[i]});
+        }
+    }
+};
+
+class SingletonDatabase : public Database
+{
+public:
+    static constexpr const char *CAPITALS_TXT = "capitals.txt";
+    static constexpr const char *CAPITALS_SNAP = "capitals.snap";
+
+private:
+    SingletonDatabase() : capitals(new CityTable{load().value_or(CityTable{})})
+    {
+        std::cout << "Initializing the Database\n";
+    }
+
+    ~SingletonDatabase()
+    {
+        stop_auto_reload();
+        delete capitals.load();
+    }
+
+    // compiled snapshot if there is an up to date one (no parsing), the text file otherwise
+    // nullopt if neither can be loaded
+    static std::optional<CityTable> load()
+    {
+        if(auto snapshot = open_snapshot(CAPITALS_SNAP, CAPITALS_TXT)) return snapshot;
+        return load_capitals(CAPITALS_TXT);
+    }
+
+    /*
+        Hot reload: a new table is built off the read path and published with one atomic exchange. Readers
+        pin the epoch domain around their lookup, so the table they loaded stays alive until they are done
+        and the old one is only deleted once no reader can see it. Readers never block and never see a
+        half-built table.
+    */
+    std::atomic<const CityTable*> capitals;
+    EpochDomain epochs;
+
+    std::mutex reload_mtx;
+    std::jthread reloader;
+public:
+    SingletonDatabase(SingletonDatabase const&) = delete;
+    SingletonDatabase& operator=(SingletonDatabase const&) = delete;
+
+    static SingletonDatabase& getInstance() {
+        // Meyer's Singleton : Guaranted to be thread safe from C++11 Standard.
+        static SingletonDatabase db;
+        return db;
+    }
+
+    int get_population(const std::string& name) override {
+        auto guard = epochs.pin();
+        // a miss returns 0 without inserting anything
+        return capitals.load()->find(name).value_or(0);
+    }
+
+    void get_populations(std::span<const std::string_view> names, std::span<int64_t> out) override {
+        // one pin for the whole batch, every name is answered from the same version
+        auto guard = epochs.pin();
+        capitals.load()->find_batch(names, out);
+    }
+
+    // Rebuilds the table from disk and publishes it, safe to call while readers are running
+    // If nothing can be loaded the current table stays in service and false is returned
+    bool reload() {
+        // held across the load too: two reloads racing could otherwise publish the older file last
+        std::scoped_lock<std::mutex> lock{reload_mtx};
+        auto loaded = load();
+        if(!loaded) return false;
+
+        auto next = new CityTable{std::move(*loaded)};
+        epochs.retire(capitals.exchange(next));
+        return true;
+    }
+
+    // Background mode: every interval, reload if capitals.txt or capitals.snap changed on disk
+    void start_auto_reload(std::chrono::milliseconds interval) {
+        stop_auto_reload();
+        reloader = std::jthread{[this, interval](std::stop_token stop) {
+            auto stamps = [] {
+                return std::make_pair(snapshot_source_stamp(CAPITALS_TXT), snapshot_source_stamp(CAPITALS_SNAP));
+            };
+            auto seen = stamps();
+
+            std::mutex mtx;
+            std::condition_variable_any cv;
+            std::unique_lock<std::mutex> lock{mtx};
+            while(!cv.wait_for(lock, stop, interval, [] { return false; })) {
+                if(stop.stop_requested()) return;
+                auto now = stamps();
+                if(now == seen) continue;
+                if(reload()) seen = now;        // on failure retry next tick
+            }
+        }};
+    }
+
+    void stop_auto_reload() {
+        if(reloader.joinable()) {
+            reloader.request_stop();
+            reloader.join();
+        }
+    }
+};
+
+class DummyDatabse : public Database
+{
+    std::map<std::string, int> data_;
+public:
+    DummyDatabse() {
+        data_["alpha"] = 1;
+        data_["beta"] = 2;
+        data_["gamma"] = 3;
+    }
+
+    int get_population(const std::string& name) override {
+        return 0;
+    }
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only memory mapping of a whole file, unmapped when the last owner goes away
+class MappedFile
+{
+    const char *data_{nullptr};
+    size_t size_{0};
+
+    MappedFile(const char *data, size_t size) : data_(data), size_(size) {}
+
+public:
+    // nullptr if the file cannot be opened or mapped
+    static std::shared_ptr<const MappedFile> open(const std::string &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd < 0) return nullptr;
+
+        struct stat st;
+        if(::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return nullptr;
+        }
+
+        size_t size = static_cast<size_t>(st.st_size);
+        void *data = nullptr;
+        if(size != 0) {
+            data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data == MAP_FAILED) {
+                ::close(fd);
+                return nullptr;
+            }
+        }
+        ::close(fd);        // the mapping stays valid without the descriptor
+
+        if(data) ::madvise(data, size, MADV_WILLNEED);
+        return std::shared_ptr<const MappedFile>(new MappedFile(static_cast<const char*>(data), size));
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+        if(data_) ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+};
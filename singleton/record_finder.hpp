@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "database.hpp"
+#include "population_sum.hpp"
+
+// Looks names up through Database::get_populations in fixed size chunks and sums each chunk with SIMD
+inline int64_t batched_total_population(Database &db, const std::vector<std::string> &names)
+{
+    static constexpr size_t CHUNK = 1024;
+    std::array<std::string_view, CHUNK> keys;
+    std::array<int64_t, CHUNK> populations;
+
+    int64_t result{0};
+    for(size_t base = 0; base < names.size(); base += CHUNK) {
+        const size_t n = std::min(CHUNK, names.size() - base);
+        for(size_t i = 0; i < n; ++i) keys[i] = names[base + i];
+
+        db.get_populations({keys.data(), n}, {populations.data(), n});
+        result += sum_populations({populations.data(), n});
+    }
+    return result;
+}
+
+// Ends up being integration test instead of unit test as it is heavily dependent on SingletonDatabse instance
+struct SingletonRecordFinder
+{
+    int64_t total_population(std::vector<std::string> &names) {
+        return batched_total_population(SingletonDatabase::getInstance(), names);
+    }
+};
+
+// Have DB instance through dependency Injection            # Can be used for unit tests
+struct ConfigurableRecordFinder
+{
+    Database& db_;
+    ConfigurableRecordFinder(Database &db) : db_(db) {}
+
+    int64_t total_population(std::vector<std::string> &names) {
+        return batched_total_population(db_, names);
+    }
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "city_table.hpp"
+#include "mapped_file.hpp"
+
+// Binary snapshot of a CityTable
+/*
+    Layout (native endian, every section 64-byte aligned):
+        SnapshotHeader
+        slots   : CityTable::Slot[slot_count]      open addressing index, population stored in the slot
+        pool    : city names, sorted, back to back  slots point into it by offset/length
+
+    Opening a snapshot is an mmap plus a check of the header, the table is then served straight from the
+    mapping: no parsing, no hashing of names, no allocation, nothing proportional to the file's size. The
+    header records size and mtime of the text file it was compiled from; if the text file changed since, the
+    snapshot is stale and not used.
+
+    The file is not trusted: every header field is bounds checked without overflow, and CityTable checks each
+    slot it probes against the pool and never probes more than slot_count slots, so a corrupted slot array
+    gives wrong answers at worst, never a read outside the mapping or an endless probe. verify_snapshot does
+    the full pass on top (checksum over slots and pool, every slot inside the pool, city_count occupied
+    slots), for tools and tests that want to know a file is intact. write_snapshot fsyncs the file before it
+    renames it into place and the directory after, so a crash leaves the old snapshot or the new one.
+*/
+struct SnapshotHeader
+{
+    static constexpr char MAGIC[8] = {'C', 'I', 'T', 'Y', 'S', 'N', 'A', 'P'};
+    static constexpr uint32_t VERSION = 2;
+    static constexpr uint32_t ENDIAN_MARK = 0x01020304;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t slot_size;
+    uint32_t reserved;
+    uint64_t source_size;
+    int64_t source_mtime_ns;
+    uint64_t city_count;
+    uint64_t slot_count;
+    uint64_t slots_offset;
+    uint64_t pool_offset;
+    uint64_t pool_size;
+    uint64_t checksum;          // snapshot_checksum of the slots section followed by the pool
+};
+
+// 64-bit multiply-xor hash, 8 bytes per step
+inline uint64_t snapshot_checksum(uint64_t h, const char *data, size_t size)
+{
+    auto mix = [&h](uint64_t word) {
+        h = (h ^ word) * 0x100000001B3ull;
+        h ^= h >> 29;
+    };
+    size_t i = 0;
+    for(; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        mix(word);
+    }
+    uint64_t tail = 0;
+    if(size > i) std::memcpy(&tail, data + i, size - i);
+    mix(tail ^ size);
+    return h;
+}
+
+// size + mtime of the text source, {0, 0} if it does not exist
+inline std::pair<uint64_t, int64_t> snapshot_source_stamp(const std::string &source_path)
+{
+    struct stat st;
+    if(::stat(source_path.c_str(), &st) != 0) return {0, 0};
+    return {static_cast<uint64_t>(st.st_size), st.st_mtim.tv_sec * 1'000'000'000ll + st.st_mtim.tv_nsec};
+}
+
+// Compiles the text dataset at source_path into a snapshot at snapshot_path
+inline bool write_snapshot(const std::string &source_path, const std::string &snapshot_path,
+                           const std::vector<std::pair<std::string_view, int>> &entries)
+{
+    auto align = [](uint64_t n) { return (n + 63) & ~uint64_t{63}; };
+
+    // sorted, deduplicated (last one wins), so the pool is deterministic and ordered by name
+    std::vector<std::pair<std::string_view, int>> sorted(entries.rbegin(), entries.rend());
+    std::stable_sort(sorted.begin(), sorted.end(), [](auto &a, auto &b) { return a.first < b.first; });
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), [](auto &a, auto &b) { return a.first == b.first; }),
+                 sorted.end());
+
+    CityTable table{sorted};
+    uint64_t pool_size = 0;
+    for(auto &entry : sorted) pool_size += entry.first.size();
+
+    auto [source_size, source_mtime] = snapshot_source_stamp(source_path);
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SnapshotHeader::MAGIC, sizeof(header.magic));
+    header.version = SnapshotHeader::VERSION;
+    header.byte_order = SnapshotHeader::ENDIAN_MARK;
+    header.slot_size = sizeof(CityTable::Slot);
+    header.source_size = source_size;
+    header.source_mtime_ns = source_mtime;
+    header.city_count = table.size();
+    header.slot_count = table.slot_count();
+    header.slots_offset = align(sizeof(SnapshotHeader));
+    header.pool_offset = align(header.slots_offset + header.slot_count * sizeof(CityTable::Slot));
+    header.pool_size = pool_size;
+    header.checksum = snapshot_checksum(
+        snapshot_checksum(0xCBF29CE484222325ull, reinterpret_cast<const char*>(table.slots()),
+                          header.slot_count * sizeof(CityTable::Slot)),
+        table.pool(), pool_size);
+
+    std::string image(header.pool_offset + pool_size, '\0');
+    std::memcpy(image.data(), &header, sizeof(header));
+    std::memcpy(image.data() + header.slots_offset, table.slots(), header.slot_count * sizeof(CityTable::Slot));
+    if(pool_size != 0) std::memcpy(image.data() + header.pool_offset, table.pool(), pool_size);
+
+    // write to a temporary and rename, readers never see a half written snapshot
+    std::string tmp = snapshot_path + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if(fd < 0) return false;
+    bool ok = true;
+    for(size_t done = 0; ok && done < image.size();) {
+        ssize_t n = ::write(fd, image.data() + done, image.size() - done);
+        if(n > 0) done += static_cast<size_t>(n);
+        else ok = n < 0 && errno == EINTR;
+    }
+    // the data has to be on disk before the name points at it, and the new name before we report success
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    if(!ok || std::rename(tmp.c_str(), snapshot_path.c_str()) != 0) {
+        ::unlink(tmp.c_str());
+        return false;
+    }
+
+    auto slash = snapshot_path.find_last_of('/');
+    std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : snapshot_path.substr(0, slash);
+    int dir_fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if(dir_fd < 0) return false;
+    ok = ::fsync(dir_fd) == 0;
+    ::close(dir_fd);
+    return ok;
+}
+
+// header of a mapped snapshot, nullopt unless every field is in bounds of the file
+inline std::optional<SnapshotHeader> snapshot_header(const MappedFile &file)
+{
+    if(file.size() < sizeof(SnapshotHeader)) return std::nullopt;
+
+    SnapshotHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    // written as "offset <= size && count <= (size - offset) / unit" so no sum or product can wrap
+    const uint64_t size = file.size();
+    if(std::memcmp(header.magic, SnapshotHeader::MAGIC, sizeof(header.magic)) != 0 ||
+       header.version != SnapshotHeader::VERSION ||
+       header.byte_order != SnapshotHeader::ENDIAN_MARK ||
+       header.slot_size != sizeof(CityTable::Slot) ||
+       !std::has_single_bit(header.slot_count) ||
+       header.city_count >= header.slot_count ||
+       header.slots_offset % alignof(CityTable::Slot) != 0 ||
+       header.slots_offset > size ||
+       header.slot_count > (size - header.slots_offset) / sizeof(CityTable::Slot) ||
+       header.pool_offset > size ||
+       header.pool_size > size - header.pool_offset ||
+       header.pool_size > CityTable::MAX_OFFSET) {
+        return std::nullopt;
+    }
+    return header;
+}
+
+// nullopt if the snapshot is missing, has a bad header, is from another version or stale against source_path
+// constant time: slots and pool are not read here, see verify_snapshot
+inline std::optional<CityTable> open_snapshot(const std::string &snapshot_path, const std::string &source_path)
+{
+    auto file = MappedFile::open(snapshot_path);
+    if(!file) return std::nullopt;
+    auto header = snapshot_header(*file);
+    if(!header) return std::nullopt;
+
+    // a missing source is not stale, the snapshot is all we have
+    auto [source_size, source_mtime] = snapshot_source_stamp(source_path);
+    if(source_size != 0 && (source_size != header->source_size || source_mtime != header->source_mtime_ns)) {
+        return std::nullopt;
+    }
+
+    auto slots = reinterpret_cast<const CityTable::Slot*>(file->data() + header->slots_offset);
+    const char *pool = file->data() + header->pool_offset;
+    return CityTable{slots, header->slot_count, header->city_count, pool, header->pool_size, std::move(file)};
+}
+
+// Full check of a snapshot file: header, checksum, every slot inside the pool, city_count occupied slots
+inline bool verify_snapshot(const std::string &snapshot_path)
+{
+    auto file = MappedFile::open(snapshot_path);
+    if(!file) return false;
+    auto header = snapshot_header(*file);
+    if(!header) return false;
+
+    auto slots = reinterpret_cast<const CityTable::Slot*>(file->data() + header->slots_offset);
+    const char *pool = file->data() + header->pool_offset;
+
+    uint64_t checksum = snapshot_checksum(0xCBF29CE484222325ull, file->data() + header->slots_offset,
+                                          header->slot_count * sizeof(CityTable::Slot));
+    if(snapshot_checksum(checksum, pool, header->pool_size) != header->checksum) return false;
+
+    // offset and length are 32-bit, their sum cannot wrap in 64
+    uint64_t occupied = 0;
+    for(uint64_t i = 0; i < header->slot_count; ++i) {
+        const CityTable::Slot &slot = slots[i];
+        if(slot.length == 0) continue;
+        if(uint64_t{slot.offset} + slot.length > header->pool_size) return false;
+        ++occupied;
+    }
+    return occupied == header->city_count;
+}
@@ -0,0 +1,35 @@
+#include <iostream>
+#include <string>
+#include "capitals_loader.hpp"
+#include "snapshot.hpp"
+
+/*
+    Compiles the city/population text file into the binary snapshot SingletonDatabase maps at startup, then
+    reads it back through verify_snapshot.
+
+    build: g++ -std=c++20 -O2 snapshot_compiler.cc -o snapshot_compiler
+    run:   ./snapshot_compiler capitals.txt capitals.snap
+*/
+
+int main(int argc, char **argv)
+{
+    std::string source = argc > 1 ? argv[1] : "capitals.txt";
+    std::string snapshot = argc > 2 ? argv[2] : "capitals.snap";
+
+    auto entries = load_capital_entries(source);
+    if(!entries) {
+        std::cerr << "cannot read " << source << "\n";
+        return 1;
+    }
+    if(!write_snapshot(source, snapshot, entries->rows)) {
+        std::cerr << "cannot write " << snapshot << "\n";
+        return 1;
+    }
+    if(!verify_snapshot(snapshot)) {
+        std::cerr << snapshot << " does not verify\n";
+        return 1;
+    }
+
+    std::cout << "wrote " << entries->rows.size() << " records to " << snapshot << "\n";
+    return 0;
+}